@@ -0,0 +1,138 @@
+/*-----------------------------------------------------------------------*/
+/* Host (Linux) disk I/O module for FatFs, backed by an image file       */
+/*-----------------------------------------------------------------------*/
+/* Replaces diskio.c / nor.c so that ff.c and the code above it (storage,*/
+/* wave_reader, synth banks / presets) can run on a PC, against a copy   */
+/* of a real unit's flash or an image built from the disk/ folder by     */
+/* host/mkimage (see host/Makefile, "make image").                       */
+/*                                                                       */
+/* Call diskio_host_open() before f_mount().                             */
+/*-----------------------------------------------------------------------*/
+
+#include <stdio.h>
+
+#include "diskio.h"
+#include "ffconf.h"
+#include "diskio_host.h"
+
+#define HOST_SECTOR_SIZE _MAX_SS
+
+static struct
+{
+	FILE * image;
+	DWORD sectorCount;
+
+	// statistics
+	DWORD reads;
+	DWORD writes;
+	DWORD syncs;
+} host;
+
+int diskio_host_open(const char * path)
+{
+	long size;
+
+	if(host.image)
+		fclose(host.image);
+
+	if(!(host.image=fopen(path,"r+b")))
+	{
+		perror(path);
+		return -1;
+	}
+
+	fseek(host.image,0,SEEK_END);
+	size=ftell(host.image);
+	host.sectorCount=size/HOST_SECTOR_SIZE;
+
+	return 0;
+}
+
+void diskio_host_close(void)
+{
+	if(host.image)
+		fclose(host.image);
+
+	host.image=NULL;
+
+	fprintf(stderr,"diskio_host: %lu sectors read, %lu written, %lu syncs\n",
+			(unsigned long)host.reads,(unsigned long)host.writes,(unsigned long)host.syncs);
+}
+
+void diskio_host_getCounts(DWORD * reads, DWORD * writes)
+{
+	*reads=host.reads;
+	*writes=host.writes;
+}
+
+void disk_timerproc(void)
+{
+}
+
+DSTATUS disk_initialize(BYTE drv)
+{
+	return (drv || !host.image)?STA_NOINIT:0;
+}
+
+DSTATUS disk_status(BYTE drv)
+{
+	return (drv || !host.image)?STA_NOINIT:0;
+}
+
+DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, BYTE count)
+{
+	if(drv || !host.image)
+		return RES_NOTRDY;
+
+	if(sector+count>host.sectorCount)
+		return RES_PARERR;
+
+	if(fseek(host.image,(long)sector*HOST_SECTOR_SIZE,SEEK_SET) ||
+			fread(buff,HOST_SECTOR_SIZE,count,host.image)!=count)
+		return RES_ERROR;
+
+	host.reads+=count;
+
+	return RES_OK;
+}
+
+DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, BYTE count)
+{
+	if(drv || !host.image)
+		return RES_NOTRDY;
+
+	if(sector+count>host.sectorCount)
+		return RES_PARERR;
+
+	if(fseek(host.image,(long)sector*HOST_SECTOR_SIZE,SEEK_SET) ||
+			fwrite(buff,HOST_SECTOR_SIZE,count,host.image)!=count)
+		return RES_ERROR;
+
+	host.writes+=count;
+
+	return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void *buff)
+{
+	if(drv || !host.image)
+		return RES_NOTRDY;
+
+	switch(ctrl)
+	{
+		case CTRL_SYNC:
+			++host.syncs;
+			return fflush(host.image)?RES_ERROR:RES_OK;
+		case GET_SECTOR_SIZE:
+			*(WORD*)buff=HOST_SECTOR_SIZE;
+			return RES_OK;
+		case GET_SECTOR_COUNT:
+			*(DWORD*)buff=host.sectorCount;
+			return RES_OK;
+		case GET_BLOCK_SIZE:
+			*(DWORD*)buff=1;
+			return RES_OK;
+	}
+
+	return RES_PARERR;
+}
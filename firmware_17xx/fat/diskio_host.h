@@ -0,0 +1,10 @@
+#ifndef DISKIO_HOST_H
+#define DISKIO_HOST_H
+
+#include "integer.h"
+
+int diskio_host_open(const char * path);
+void diskio_host_close(void);
+void diskio_host_getCounts(DWORD * reads, DWORD * writes); // sectors, since open
+
+#endif /* DISKIO_HOST_H */
@@ -0,0 +1,580 @@
+////////////////////////////////////////////////////////////////////////////////
+// Wear levelling flash translation layer
+////////////////////////////////////////////////////////////////////////////////
+
+// Logical sectors live at their home (same physical index) until a rewrite
+// would need an erase, they are then moved to a pre-erased sector of a spare
+// pool that is allocated round robin. Only FTL_MAP_SIZE sectors can be out of
+// home, the least recently relocated one goes back home when the map is full,
+// so hot FAT/directory/config sectors rotate over the pool and cold ones stay
+// home.
+// Mapping changes are appended to a log sector, once the data is in place.
+// When the log is full, the map is written to the other log sector, header
+// last, so a power loss always leaves one valid log.
+// Units formatted before the FTL have a volume over the whole flash, it is
+// shrunk in place when its last clusters are free (they usually are, FatFs
+// allocates from the start); the boot sectors are rewritten through the FTL,
+// so this is power loss safe, and redone at the next boot if interrupted.
+
+#include <string.h>
+
+#include "ftl.h"
+
+#include "w25q.h"
+#include "rprintf.h"
+#include "synth/utils.h"
+
+#define FTL_MAGIC 0x4c54464f // "OFTL"
+#define FTL_NO_SECTOR 0xffff
+
+#define FTL_POOL_FIRST (W25Q_SECTOR_COUNT-FTL_RESERVED_SECTORS)
+#define FTL_LOG_FIRST (W25Q_SECTOR_COUNT-FTL_LOG_SECTORS)
+
+#define FTL_HEADER_SIZE 16
+#define FTL_ENTRY_SIZE 8
+#define FTL_LOG_ENTRIES ((W25Q_SECTOR_SIZE-FTL_HEADER_SIZE)/FTL_ENTRY_SIZE)
+
+#define FTL_ENTRY_CHECK(l,p) ((l)^(p)^0x5a5a)
+
+// see ff.c
+#define FTL_MIN_FAT16 4086
+#define FTL_MIN_FAT32 65526
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t generation;
+	uint16_t nextSpare; // pool index
+	uint16_t check;
+	uint32_t reserved;
+} ftlHeader_t;
+
+typedef struct
+{
+	uint16_t logical;
+	uint16_t physical; // logical==physical: back home
+	uint16_t check;
+	uint16_t reserved;
+} ftlEntry_t;
+
+static struct
+{
+	int8_t active;
+
+	struct
+	{
+		uint16_t logical; // FTL_NO_SECTOR when free
+		uint16_t physical;
+		uint32_t stamp;
+	} map[FTL_MAP_SIZE];
+
+	uint32_t stamp;
+	uint16_t nextSpare;
+	uint8_t erased[(FTL_POOL_SECTORS+7)/8]; // pool sectors known to be blank
+
+	int8_t log; // current log sector
+	uint32_t generation;
+	uint16_t logCount;
+
+	// statistics
+	uint32_t relocations;
+	uint32_t evictions;
+	uint32_t compactions;
+	uint32_t erases;
+} ftl;
+
+static FORCEINLINE int8_t isErased(uint16_t spare)
+{
+	return (ftl.erased[spare>>3]>>(spare&7))&1;
+}
+
+static FORCEINLINE void setErased(uint16_t spare, int8_t erased)
+{
+	if(erased)
+		ftl.erased[spare>>3]|=1<<(spare&7);
+	else
+		ftl.erased[spare>>3]&=~(1<<(spare&7));
+}
+
+static uint16_t checkHeader(uint32_t generation, uint16_t nextSpare)
+{
+	return (generation^(generation>>16)^nextSpare^0x5a5a)&0xffff;
+}
+
+static int findEntry(uint32_t logical)
+{
+	for(int i=0;i<FTL_MAP_SIZE;++i)
+		if(ftl.map[i].logical==logical)
+			return i;
+
+	return -1;
+}
+
+static int8_t isSpareUsed(uint16_t spare)
+{
+	for(int i=0;i<FTL_MAP_SIZE;++i)
+		if(ftl.map[i].logical!=FTL_NO_SECTOR && ftl.map[i].physical==FTL_POOL_FIRST+spare)
+			return 1;
+
+	return 0;
+}
+
+static uint16_t findFreeSpare(void)
+{
+	uint16_t spare=ftl.nextSpare;
+
+	// there are always more spares than map entries
+	while(isSpareUsed(spare))
+		spare=(spare+1)%FTL_POOL_SECTORS;
+
+	return spare;
+}
+
+static void setEntry(uint32_t logical, uint32_t physical)
+{
+	int e=findEntry(logical);
+
+	if(logical==physical)
+	{
+		if(e>=0)
+			ftl.map[e].logical=FTL_NO_SECTOR;
+		return;
+	}
+
+	if(e<0)
+		e=findEntry(FTL_NO_SECTOR);
+
+	if(e<0)
+	{
+		rprintf(0,"ftl: map overflow\n");
+		return;
+	}
+
+	ftl.map[e].logical=logical;
+	ftl.map[e].physical=physical;
+	ftl.map[e].stamp=++ftl.stamp;
+}
+
+static void writeLog(int8_t log, uint16_t index, uint32_t logical, uint32_t physical)
+{
+	ftlEntry_t entry;
+
+	entry.logical=logical;
+	entry.physical=physical;
+	entry.check=FTL_ENTRY_CHECK(logical,physical);
+	entry.reserved=0xffff;
+
+	W25Q_program(((FTL_LOG_FIRST+log)<<W25Q_SECTOR_BITS)+FTL_HEADER_SIZE+index*FTL_ENTRY_SIZE,(uint8_t*)&entry,FTL_ENTRY_SIZE);
+}
+
+static void writeLogHeader(int8_t log)
+{
+	ftlHeader_t header;
+
+	header.magic=FTL_MAGIC;
+	header.generation=ftl.generation;
+	header.nextSpare=ftl.nextSpare;
+	header.check=checkHeader(ftl.generation,ftl.nextSpare);
+	header.reserved=0xffffffff;
+
+	W25Q_program((FTL_LOG_FIRST+log)<<W25Q_SECTOR_BITS,(uint8_t*)&header,FTL_HEADER_SIZE);
+}
+
+static void compactLog(void)
+{
+	int8_t log=(ftl.log+1)%FTL_LOG_SECTORS;
+
+	W25Q_eraseSector(FTL_LOG_FIRST+log);
+	++ftl.erases;
+
+	// oldest first, replay order gives back the eviction order
+
+	ftl.logCount=0;
+	for(uint32_t prev=0;;)
+	{
+		int e=-1;
+
+		for(int i=0;i<FTL_MAP_SIZE;++i)
+			if(ftl.map[i].logical!=FTL_NO_SECTOR && ftl.map[i].stamp>prev && (e<0 || ftl.map[i].stamp<ftl.map[e].stamp))
+				e=i;
+
+		if(e<0)
+			break;
+
+		writeLog(log,ftl.logCount++,ftl.map[e].logical,ftl.map[e].physical);
+		prev=ftl.map[e].stamp;
+	}
+
+	// header last, the new log only becomes valid when complete
+
+	++ftl.generation;
+	writeLogHeader(log);
+
+	W25Q_eraseSector(FTL_LOG_FIRST+ftl.log);
+	++ftl.erases;
+
+	ftl.log=log;
+	++ftl.compactions;
+}
+
+static void appendLog(uint32_t logical, uint32_t physical)
+{
+	if(ftl.logCount>=FTL_LOG_ENTRIES)
+		compactLog();
+
+	writeLog(ftl.log,ftl.logCount++,logical,physical);
+
+	setEntry(logical,physical);
+}
+
+static void evictOldest(void)
+{
+	uint8_t page[W25Q_PAGE_SIZE];
+	uint32_t home,physical;
+	int e=0;
+
+	for(int i=1;i<FTL_MAP_SIZE;++i)
+		if(ftl.map[i].stamp<ftl.map[e].stamp)
+			e=i;
+
+	home=ftl.map[e].logical;
+	physical=ftl.map[e].physical;
+
+	// copy back home, the log still points to the pool copy until this is done
+
+	W25Q_eraseSector(home);
+	++ftl.erases;
+
+	for(int p=0;p<W25Q_PAGES_PER_SECTOR;++p)
+	{
+		int8_t blank=1;
+		uint32_t offset=p<<W25Q_PAGE_BITS;
+
+		W25Q_read((physical<<W25Q_SECTOR_BITS)+offset,page,W25Q_PAGE_SIZE);
+
+		for(int i=0;i<W25Q_PAGE_SIZE;++i)
+			if(page[i]!=0xff)
+			{
+				blank=0;
+				break;
+			}
+
+		if(!blank)
+			W25Q_program((home<<W25Q_SECTOR_BITS)+offset,page,W25Q_PAGE_SIZE);
+	}
+
+	appendLog(home,home);
+
+	setErased(physical-FTL_POOL_FIRST,0);
+	++ftl.evictions;
+}
+
+static void eraseAhead(void)
+{
+	uint16_t spare=findFreeSpare();
+
+	if(!isErased(spare))
+	{
+		W25Q_eraseSector(FTL_POOL_FIRST+spare);
+		setErased(spare,1);
+		++ftl.erases;
+	}
+}
+
+static uint32_t ldWord(const uint8_t * p)
+{
+	return p[0]|(p[1]<<8);
+}
+
+static uint32_t ldDword(const uint8_t * p)
+{
+	return p[0]|(p[1]<<8)|(p[2]<<16)|((uint32_t)p[3]<<24);
+}
+
+static void stDword(uint8_t * p, uint32_t v)
+{
+	p[0]=v;
+	p[1]=v>>8;
+	p[2]=v>>16;
+	p[3]=v>>24;
+}
+
+static int8_t isBootSector(const uint8_t * s)
+{
+	return s[0]==0xeb || s[0]==0xe9;
+}
+
+static uint32_t getVolumeEnd(const uint8_t * s)
+{
+	uint32_t total;
+
+	if(s[510]!=0x55 || s[511]!=0xaa)
+		return 0; // not formatted
+
+	if(isBootSector(s))
+	{
+		// boot sector, no partition table
+		total=ldWord(&s[19]);
+		if(!total)
+			total=ldDword(&s[32]);
+		return total;
+	}
+
+	// first partition
+	return ldDword(&s[454])+ldDword(&s[458]);
+}
+
+static void readLogical(uint32_t sector, uint8_t * buffer)
+{
+	W25Q_readSector(ftl_getPhysicalSector(sector),buffer);
+}
+
+static int8_t shrinkVolume(uint8_t * scratch, int8_t apply)
+{
+	uint32_t volume,total,newTotal,fatSize,sysSectors,clusters,newClusters,entrySize,reserved,fsInfo,backup;
+	uint32_t c,sector,prevSector;
+	uint8_t spc;
+	
+	// boot sector and FAT geometry, as FatFs computes it
+
+	readLogical(0,scratch);
+	
+	if(getVolumeEnd(scratch)<=FTL_POOL_FIRST)
+		return 1;
+	
+	volume=isBootSector(scratch)?0:ldDword(&scratch[454]);
+	
+	if(volume)
+		readLogical(volume,scratch);
+	
+	if(!isBootSector(scratch) || ldWord(&scratch[11])!=W25Q_SECTOR_SIZE || !scratch[13] || !scratch[16])
+		return 0;
+	
+	spc=scratch[13];
+	total=ldWord(&scratch[19])?ldWord(&scratch[19]):ldDword(&scratch[32]);
+	fatSize=ldWord(&scratch[22])?ldWord(&scratch[22]):ldDword(&scratch[36]);
+	reserved=ldWord(&scratch[14]);
+	sysSectors=reserved+scratch[16]*fatSize+(ldWord(&scratch[17])*32+W25Q_SECTOR_SIZE-1)/W25Q_SECTOR_SIZE;
+	fsInfo=ldWord(&scratch[48]);
+	backup=ldWord(&scratch[50]);
+	
+	newTotal=FTL_POOL_FIRST-volume;
+	clusters=(total-sysSectors)/spc;
+	newClusters=(newTotal-sysSectors)/spc;
+	
+	// FAT12 isn't handled, the FAT type must not change
+
+	if(newClusters<FTL_MIN_FAT16 || (clusters>=FTL_MIN_FAT32)!=(newClusters>=FTL_MIN_FAT32))
+		return 0;
+	
+	entrySize=(clusters>=FTL_MIN_FAT32)?4:2;
+
+	// the clusters that go away must be free
+
+	prevSector=UINT32_MAX;
+	for(c=newClusters+2;c<clusters+2;++c)
+	{
+		sector=volume+reserved+c*entrySize/W25Q_SECTOR_SIZE;
+		
+		if(sector!=prevSector)
+		{
+			readLogical(sector,scratch);
+			prevSector=sector;
+		}
+		
+		if((entrySize==4)?(ldDword(&scratch[(c*4)&W25Q_SECTOR_MASK])&0x0fffffff):ldWord(&scratch[(c*2)&W25Q_SECTOR_MASK]))
+			return 0;
+	}
+	
+	if(!apply)
+		return 1;
+	
+	// boot sector(s), then the partition, all through the FTL
+	
+	for(int8_t i=0;i<((entrySize==4 && backup)?2:1);++i)
+	{
+		sector=volume+(i?backup:0);
+		readLogical(sector,scratch);
+		
+		if(ldWord(&scratch[19]) && newTotal<0x10000)
+		{
+			scratch[19]=newTotal;
+			scratch[20]=newTotal>>8;
+		}
+		else
+		{
+			scratch[19]=scratch[20]=0;
+			stDword(&scratch[32],newTotal);
+		}
+		
+		ftl_writeSector(sector,scratch);
+	}
+	
+	if(entrySize==4 && fsInfo)
+	{
+		// free clusters count is unknown now
+		readLogical(volume+fsInfo,scratch);
+		stDword(&scratch[488],0xffffffff);
+		ftl_writeSector(volume+fsInfo,scratch);
+	}
+	
+	if(volume)
+	{
+		readLogical(0,scratch);
+		stDword(&scratch[458],newTotal);
+		ftl_writeSector(0,scratch);
+	}
+	
+	rprintf(0,"ftl: volume shrunk from %d to %d sectors\n",total,newTotal);
+	
+	return 1;
+}
+
+void ftl_init(uint8_t * scratch)
+{
+	ftlHeader_t header;
+	const ftlEntry_t * entries;
+
+	memset(&ftl,0,sizeof(ftl));
+	for(int i=0;i<FTL_MAP_SIZE;++i)
+		ftl.map[i].logical=FTL_NO_SECTOR;
+	ftl.log=-1;
+
+	// find the most recent complete log
+
+	for(int8_t log=0;log<FTL_LOG_SECTORS;++log)
+	{
+		W25Q_read((FTL_LOG_FIRST+log)<<W25Q_SECTOR_BITS,(uint8_t*)&header,FTL_HEADER_SIZE);
+
+		if(header.magic!=FTL_MAGIC || header.check!=checkHeader(header.generation,header.nextSpare) || header.nextSpare>=FTL_POOL_SECTORS)
+			continue;
+
+		if(ftl.log<0 || header.generation>ftl.generation)
+		{
+			ftl.log=log;
+			ftl.generation=header.generation;
+			ftl.nextSpare=header.nextSpare;
+		}
+	}
+
+	if(ftl.log<0)
+	{
+		// no log, only enable the FTL when the volume leaves the reserved sectors alone or can be shrunk
+
+		if(!shrinkVolume(scratch,0))
+		{
+			rprintf(0,"ftl: volume overlaps reserved sectors, disabled\n");
+			return;
+		}
+
+		for(int8_t log=0;log<FTL_LOG_SECTORS;++log)
+			W25Q_eraseSector(FTL_LOG_FIRST+log);
+
+		ftl.log=0;
+		ftl.generation=1;
+		ftl.nextSpare=0;
+		writeLogHeader(0);
+	}
+
+	// replay the log
+
+	W25Q_readSector(FTL_LOG_FIRST+ftl.log,scratch);
+	entries=(const ftlEntry_t *)&scratch[FTL_HEADER_SIZE];
+
+	for(ftl.logCount=0;ftl.logCount<FTL_LOG_ENTRIES;++ftl.logCount)
+	{
+		const ftlEntry_t * entry=&entries[ftl.logCount];
+
+		if(entry->logical==0xffff && entry->physical==0xffff && entry->check==0xffff)
+			break;
+
+		// partially programmed entries are skipped
+		if(entry->check!=FTL_ENTRY_CHECK(entry->logical,entry->physical) ||
+				entry->logical>=FTL_POOL_FIRST || entry->physical>=FTL_LOG_FIRST ||
+				(entry->physical!=entry->logical && entry->physical<FTL_POOL_FIRST))
+			continue;
+
+		setEntry(entry->logical,entry->physical);
+
+		if(entry->physical>=FTL_POOL_FIRST)
+			ftl.nextSpare=(entry->physical-FTL_POOL_FIRST+1)%FTL_POOL_SECTORS;
+	}
+
+	ftl.active=1;
+	
+	// pre-FTL volume, also after a power loss while shrinking
+
+	if(!shrinkVolume(scratch,1))
+		rprintf(0,"ftl: volume overlaps reserved sectors\n");
+
+#ifdef DEBUG
+	rprintf(0,"ftl: log %d generation %d entries %d\n",ftl.log,ftl.generation,ftl.logCount);
+#endif
+}
+
+uint32_t ftl_getSectorCount(void)
+{
+	return ftl.active?FTL_POOL_FIRST:W25Q_SECTOR_COUNT;
+}
+
+uint32_t ftl_getPhysicalSector(uint32_t sector)
+{
+	int e;
+
+	if(!ftl.active || (e=findEntry(sector))<0)
+		return sector;
+
+	return ftl.map[e].physical;
+}
+
+uint32_t ftl_writeSector(uint32_t sector, const uint8_t * buffer)
+{
+	uint32_t physical,pages;
+	uint16_t spare;
+
+	physical=ftl_getPhysicalSector(sector);
+	pages=W25Q_compareSector(physical,buffer);
+
+	// unchanged or only clearing bits: program in place
+
+	if(!ftl.active || !(pages&W25Q_ERASE))
+	{
+		if(pages)
+			W25Q_programSector(physical,buffer,pages);
+		return pages;
+	}
+
+	// an erase would be needed, move to a spare instead
+
+	if(findEntry(sector)<0 && findEntry(FTL_NO_SECTOR)<0)
+		evictOldest();
+
+	spare=findFreeSpare();
+
+	pages=W25Q_compareSector(FTL_POOL_FIRST+spare,buffer);
+	W25Q_programSector(FTL_POOL_FIRST+spare,buffer,pages);
+	setErased(spare,0);
+
+	if(pages&W25Q_ERASE)
+		++ftl.erases;
+
+	ftl.nextSpare=(spare+1)%FTL_POOL_SECTORS;
+
+	// data is in place, commit the new mapping
+
+	appendLog(sector,FTL_POOL_FIRST+spare);
+
+	if(physical>=FTL_POOL_FIRST)
+		setErased(physical-FTL_POOL_FIRST,0);
+
+	++ftl.relocations;
+
+	eraseAhead();
+
+#ifdef DEBUG
+	rprintf(0,"ftl: %d -> %d relocations %d evictions %d compactions %d erases %d\n",
+			sector,FTL_POOL_FIRST+spare,ftl.relocations,ftl.evictions,ftl.compactions,ftl.erases);
+#endif
+
+	return pages|FTL_RELOCATED;
+}
@@ -0,0 +1,21 @@
+#ifndef FTL_H
+#define FTL_H
+
+#include "lpc_types.h"
+
+#define FTL_LOG_SECTORS 2
+#define FTL_POOL_SECTORS 126
+#define FTL_RESERVED_SECTORS (FTL_LOG_SECTORS+FTL_POOL_SECTORS)
+
+#define FTL_MAP_SIZE 64 // logical sectors that can live in the pool at the same time
+
+#define FTL_RELOCATED 0x40000000 // ftl_writeSector() pages mask flag, written to a spare instead of erasing in place
+
+void ftl_init(uint8_t * scratch); // scratch: one sector worth of temporary storage
+
+uint32_t ftl_getSectorCount(void);
+uint32_t ftl_getPhysicalSector(uint32_t sector);
+
+uint32_t ftl_writeSector(uint32_t sector, const uint8_t * buffer); // returns the pages mask programmed, see W25Q_compareSector
+
+#endif /* FTL_H */
@@ -10,6 +10,22 @@
 #include <windows.h>
 #include <tchar.h>
 
+#elif defined(__linux__)	/* Host build, see diskio_host.c */
+
+#include <stdint.h>
+
+typedef int				INT;
+typedef unsigned int	UINT;
+typedef unsigned char	UCHAR;
+typedef unsigned char	BYTE;
+typedef int16_t			SHORT;
+typedef uint16_t		USHORT;
+typedef uint16_t		WORD;
+typedef uint16_t		WCHAR;
+typedef int32_t			LONG;
+typedef uint32_t		ULONG;
+typedef uint32_t		DWORD;
+
 #else			/* Embedded platform */
 
 /* These types must be 16-bit, 32-bit or larger integer */
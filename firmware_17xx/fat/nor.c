@@ -4,14 +4,41 @@
 
 #include "main.h"
 #include "w25q.h"
+#include "ftl.h"
 #include "rprintf.h"
 #include "synth/utils.h"
+#include "usb/msc_scsi.h"
+
+// no write-back cache (no RAM for a second 4KB sector), writes only skip no-op erases:
+// each written sector is compared with the flash page by page, unchanged pages are skipped
+// and erases only happen when a bit has to go from 0 to 1, FatFs rewriting a FAT sector with
+// one more cluster costs a page program, nor_getStats() tells how often that happens
+
+static struct
+{
+	int8_t initialized;
+
+	struct nor_stats_s stats;
+} nor;
 
 DSTATUS nor_disk_initialize(void)
 {
+	// called by main() and again by the first mount
+	if(nor.initialized)
+		return 0;
+	
 	if(W25Q_init())
 		return STA_NOINIT;
 	
+	// boot time, nothing uses the USB block buffer yet
+	ftl_init(SCSIGetBlockBuffer());
+
+#ifdef DEBUG
+	W25Q_benchmark(SCSIGetBlockBuffer());
+#endif
+	
+	nor.initialized=1;
+	
 	return 0;
 }
 
@@ -30,13 +57,13 @@ DRESULT nor_disk_ioctl(BYTE ctrl, void *buff)
 	res=RES_OK;
 	switch(ctrl) {
 		case CTRL_SYNC:
-			/* nothing */
+			// writes are synchronous
 			break;
 		case GET_SECTOR_SIZE:
 			*(WORD*)buff=W25Q_SECTOR_SIZE;
 			break;
 		case GET_SECTOR_COUNT:
-			*(DWORD*)buff=W25Q_SECTOR_COUNT;
+			*(DWORD*)buff=ftl_getSectorCount();
 			break;
 		case GET_BLOCK_SIZE:
 			*(DWORD*)buff=1;
@@ -52,12 +79,25 @@ DRESULT nor_disk_read(BYTE* buff, DWORD sector, BYTE count)
 {
 //	rprintf(0,"nor_disk_read %x %d\n",sector,count);
 	
-	for(;count;--count)
+	uint8_t * buf=buff;
+	DWORD sec=sector;
+	BYTE cnt=count;
+	
+	while(cnt)
 	{
-		W25Q_readSector(sector,buff);
-
-		buff+=W25Q_SECTOR_SIZE;
-		++sector;
+		// read runs that are contiguous in flash at once
+		
+		uint32_t physical=ftl_getPhysicalSector(sec);
+		uint32_t run=1;
+		
+		while(run<cnt && ftl_getPhysicalSector(sec+run)==physical+run)
+			++run;
+		
+		W25Q_readSectors(physical,run,buf);
+		
+		buf+=run*W25Q_SECTOR_SIZE;
+		sec+=run;
+		cnt-=run;
 	}
 	
 	return RES_OK;
@@ -67,9 +107,26 @@ DRESULT nor_disk_write(const BYTE* buff, DWORD sector, BYTE count)
 {
 //	rprintf(0,"nor_disk_write %x %d\n",sector,count);
 
+	uint32_t pages;
+
 	for(;count;--count)
 	{
-		W25Q_writeSector(sector,buff);
+		pages=ftl_writeSector(sector,buff);
+		
+		++nor.stats.writes;
+		if(!pages)
+			++nor.stats.unchanged;
+		else if(pages&FTL_RELOCATED)
+			++nor.stats.relocations;
+		else if(pages&W25Q_ERASE)
+			++nor.stats.erases;
+		else
+			++nor.stats.erasesAvoided;
+
+#ifdef DEBUG
+		rprintf(0,"nor write %d pages %08lX writes %d unchanged %d avoided %d relocations %d erases %d\n",
+				sector,pages,nor.stats.writes,nor.stats.unchanged,nor.stats.erasesAvoided,nor.stats.relocations,nor.stats.erases);
+#endif		
 		
 		buff+=W25Q_SECTOR_SIZE;
 		++sector;
@@ -78,6 +135,11 @@ DRESULT nor_disk_write(const BYTE* buff, DWORD sector, BYTE count)
 	return RES_OK;
 }
 
+void nor_getStats(struct nor_stats_s * stats)
+{
+	*stats=nor.stats;
+}
+
 void nor_test(void)
 {
 	FRESULT res;
@@ -4,12 +4,23 @@
 #include "lpc_types.h"
 #include "diskio.h"
 
+// nor_disk_write() outcomes, since boot
+struct nor_stats_s
+{
+	uint32_t writes; // disk_write sectors
+	uint32_t unchanged; // flash already held the data
+	uint32_t erasesAvoided; // only bits going from 1 to 0, programmed in place without an erase
+	uint32_t relocations; // would have needed an erase, the FTL wrote a spare instead
+	uint32_t erases; // erased in place (FTL not active)
+};
+
 DSTATUS nor_disk_initialize(void);
 DSTATUS nor_disk_status(void);
 DRESULT nor_disk_ioctl(BYTE ctrl, void *buff);
 DRESULT nor_disk_read(BYTE* buff, DWORD sector, BYTE count);
 DRESULT nor_disk_write(const BYTE* buff, DWORD sector, BYTE count);
 
+void nor_getStats(struct nor_stats_s * stats);
 void nor_test(void);
 
 #endif /* NOR_H */
@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: envelope update benchmark, adsr_updateBank() (skips steady
+// envelopes) vs adsr_update() on every envelope (what refreshVoice did), with
+// the synth's 3 banks of SYNTH_VOICE_COUNT envelopes, 2 notes held
+////////////////////////////////////////////////////////////////////////////////
+
+// usage: adsrbench
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "synth/adsr.h"
+
+#define BANK_COUNT 3 // amp, filter, wavemod
+#define HELD_NOTES 2
+#define TICKS 1000 // per run, short enough to stay in the measured stage
+#define RUNS 1000
+#define MAX_TICKS_TO_SUSTAIN 100000000
+
+static struct adsr_s banks[BANK_COUNT][SYNTH_VOICE_COUNT];
+static struct adsr_s saved[BANK_COUNT][SYNTH_VOICE_COUNT];
+static volatile uint16_t sink;
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec*1e9+ts.tv_nsec;
+}
+
+static void tickBank(void)
+{
+	for(int b=0;b<BANK_COUNT;++b)
+		adsr_updateBank(banks[b],SYNTH_VOICE_COUNT);
+}
+
+static void tickAll(void)
+{
+	for(int b=0;b<BANK_COUNT;++b)
+		for(int v=0;v<SYNTH_VOICE_COUNT;++v)
+			adsr_update(&banks[b][v]);
+}
+
+static double measure(void (*tick)(void))
+{
+	double start,total=0.0;
+
+	for(int r=0;r<RUNS;++r)
+	{
+		memcpy(banks,saved,sizeof(banks));
+
+		start=now();
+		for(int t=0;t<TICKS;++t)
+		{
+			tick();
+			sink=banks[0][0].output;
+		}
+		total+=now()-start;
+	}
+
+	return total/(RUNS*TICKS);
+}
+
+static int activeCount(void)
+{
+	int n=0;
+
+	for(int b=0;b<BANK_COUNT;++b)
+		for(int v=0;v<SYNTH_VOICE_COUNT;++v)
+			n+=banks[b][v].active;
+
+	return n;
+}
+
+static void report(const char * state)
+{
+	double all,bank;
+	int active;
+
+	memcpy(saved,banks,sizeof(banks));
+	active=activeCount();
+
+	all=measure(tickAll);
+	bank=measure(tickBank);
+
+	printf("%-30s %2d of %2d active, %6.1f ns/tick all, %6.1f ns/tick bank, %4.1fx\n",
+			state,active,BANK_COUNT*SYNTH_VOICE_COUNT,all,bank,all/bank);
+
+	memcpy(banks,saved,sizeof(banks));
+}
+
+int main(int argc, char ** argv)
+{
+	int t;
+
+	// same setup as synth.c refreshEnvSettings / synth_assignerEvent
+
+	for(int b=0;b<BANK_COUNT;++b)
+		for(int v=0;v<SYNTH_VOICE_COUNT;++v)
+		{
+			struct adsr_s * a=&banks[b][v];
+
+			adsr_init(a);
+			adsr_setSpeedShift(a,2);
+			adsr_setShape(a,ADSR_EXP_ALL,0);
+			adsr_setDelayHoldCVs(a,0,0);
+			adsr_setCVs(a,30000,40000,40000,40000,0,0x0f);
+			adsr_setCVs(a,0,0,0,0,UINT16_MAX,0x10);
+		}
+
+	report("idle");
+
+	for(int b=0;b<BANK_COUNT;++b)
+		for(int v=0;v<HELD_NOTES;++v)
+			adsr_setGate(&banks[b][v],1);
+
+	report("2 held, attack");
+
+	for(t=0;t<MAX_TICKS_TO_SUSTAIN && adsr_getStage(&banks[0][0])!=sSustain;++t)
+		tickBank();
+
+	printf("(sustain after %d ticks)\n",t);
+	report("2 held, sustain");
+
+	for(int b=0;b<BANK_COUNT;++b)
+		for(int v=0;v<HELD_NOTES;++v)
+			adsr_setGate(&banks[b][v],0);
+
+	report("2 released");
+
+	return 0;
+}
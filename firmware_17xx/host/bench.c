@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: storage benchmark, runs the synth's own loading code against a
+// disk image (see mkimage.c) and reports time and sectors accessed per call
+////////////////////////////////////////////////////////////////////////////////
+
+// usage: bench <image> [wave count]
+// the image is modified (wave indexes, binary presets), use a copy
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "synth/synth.h"
+#include "synth/storage.h"
+#include "synth/dacspi.h"
+#include "diskio_host.h"
+
+#define MAX_WAIT_UPDATES 100000
+#define OSC_UPDATES_PER_LOOP 8
+#define PREFETCH_CALLS 2 // presets prefetched by storage.c, one decode per call
+
+static FATFS fatFS;
+static uint16_t presets[PRESET_COUNT];
+static int presetCount;
+
+static struct
+{
+	const char * name;
+	int calls;
+	double start;
+	double excluded; // oscillators and prefetch, see runOscillators() / browsePresets()
+	DWORD reads,writes;
+} bench;
+
+static int putc_stdout(int c)
+{
+	return putchar(c);
+}
+
+static int putc_null(int c)
+{
+	return c;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec*1e6+ts.tv_nsec*1e-3;
+}
+
+static void benchStart(const char * name)
+{
+	bench.name=name;
+	bench.calls=0;
+	bench.excluded=0.0;
+	diskio_host_getCounts(&bench.reads,&bench.writes);
+	bench.start=now();
+}
+
+static void benchEnd(void)
+{
+	double elapsed=now()-bench.start-bench.excluded;
+	DWORD reads,writes;
+	
+	diskio_host_getCounts(&reads,&writes);
+	
+	if(!bench.calls)
+		return;
+	
+	printf("%-36s %5d calls %10.1f us/call %8.1f sectors read/call %6.1f written/call\n",
+			bench.name,bench.calls,elapsed/bench.calls,
+			(double)(reads-bench.reads)/bench.calls,(double)(writes-bench.writes)/bench.calls);
+}
+
+static void runOscillators(void)
+{
+	double start=now();
+	
+	// what the DMA IRQ does, oscillators only swap to a new wave at their
+	// cycle start and the loader can't reuse a slot before that
+	
+	for(int i=0;i<OSC_UPDATES_PER_LOOP;++i)
+		synth_updateOscsEvent((i&1)*DACSPI_CV_COUNT,DACSPI_BUFFER_COUNT/4);
+	
+	bench.excluded+=now()-start;
+}
+
+static void update(void)
+{
+	synth_update();
+	runOscillators();
+}
+
+static void idle(void)
+{
+	// let the main loop finish background work (wave loads, prefetch)
+	for(int i=0;i<MAX_WAIT_UPDATES/100;++i)
+		update();
+}
+
+static void loadPresets(void)
+{
+	for(int i=0;i<presetCount;++i)
+	{
+		preset_invalidateCache();
+		preset_loadCurrent(presets[i]);
+		++bench.calls;
+	}
+}
+
+static void browsePresets(void)
+{
+	double start;
+	
+	// one step at a time in the same direction, as with the UI, prefetch between steps
+	// (its time is excluded, its sectors are counted)
+	
+	for(int i=1;i<presetCount;++i)
+	{
+		start=now();
+		for(int p=0;p<PREFETCH_CALLS;++p)
+			preset_prefetch();
+		bench.excluded+=now()-start;
+
+		preset_loadCurrent((presets[0]+i)%PRESET_COUNT);
+		++bench.calls;
+	}
+}
+
+static void loadWaves(int count)
+{
+	char name[MAX_FILENAME];
+	uint16_t * data;
+	int i,u;
+	
+	for(int bank=0;bench.calls<count && synth_getBankName(bank,currentPreset->oscBank[abxAMain]);++bank)
+	{
+		synth_refreshCurWaveNames(abxAMain,1);
+
+		for(i=0;bench.calls<count && synth_getWaveName(i,name);++i)
+		{
+			data=synth_getWaveformData(abxAMain);
+
+			strcpy(currentPreset->oscWave[abxAMain],name);
+			synth_refreshWaveforms(abxAMain);
+
+			for(u=0;u<MAX_WAIT_UPDATES && synth_getWaveformData(abxAMain)==data;++u)
+				update();
+
+			if(u>=MAX_WAIT_UPDATES)
+			{
+				fprintf(stderr,"%s: not loaded\n",name);
+				return;
+			}
+
+			++bench.calls;
+		}
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	FRESULT res;
+	int waveCount;
+	
+	if(argc<2)
+	{
+		fprintf(stderr,"usage: %s <image> [wave count]\n",argv[0]);
+		return 1;
+	}
+	
+	waveCount=(argc>2)?atoi(argv[2]):32;
+	
+	rprintf_devopen(0,putc_stdout);
+	rprintf_devopen(1,putc_null); // LCD
+	
+	if(diskio_host_open(argv[1]))
+		return 1;
+	
+	if((res=f_mount(0,&fatFS)))
+	{
+		fprintf(stderr,"f_mount res=%d\n",res);
+		return 1;
+	}
+	
+	benchStart("synth_init");
+	synth_init();
+	++bench.calls;
+	benchEnd();
+
+	idle();
+	
+	// wave banks, without then with the directory indexes
+	
+	synth_invalidateWaveIndexes();
+	benchStart("synth_refreshBankNames, no index");
+	synth_refreshBankNames(1,1);
+	++bench.calls;
+	benchEnd();
+	
+	benchStart("synth_refreshBankNames, indexed");
+	for(int i=0;i<100;++i)
+	{
+		synth_refreshBankNames(1,1);
+		++bench.calls;
+	}
+	benchEnd();
+	
+	// presets, text files then binary ones
+	
+	for(int i=0;i<PRESET_COUNT;++i)
+		if(preset_fileExists(i))
+			presets[presetCount++]=i;
+
+	benchStart("preset_loadCurrent, text");
+	loadPresets();
+	benchEnd();
+	
+	for(int i=0;i<presetCount;++i)
+	{
+		preset_loadCurrent(presets[i]);
+		preset_saveCurrent(presets[i]);
+	}
+	idle();
+	
+	benchStart("preset_loadCurrent, binary");
+	loadPresets();
+	benchEnd();
+	
+	preset_invalidateCache();
+	preset_loadCurrent(presets[0]);
+	
+	benchStart("preset_loadCurrent, browsing");
+	browsePresets();
+	benchEnd();
+	
+	idle();
+
+	// waves, each one a load (background loader, synth_update loop)
+	
+	benchStart("wave load");
+	loadWaves(waveCount);
+	benchEnd();
+	
+	f_mount(0,NULL);
+	diskio_host_close();
+
+	return 0;
+}
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: C versions of the CMSIS core intrinsics, then the real header for
+// the core peripherals definitions (never dereferenced on the host)
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_CORE_CM3_H
+#define HOST_CORE_CM3_H
+
+#include <stdint.h>
+
+#define __CORE_CMINSTR_H
+#define __CORE_CMFUNC_H
+
+static inline void __NOP(void) {}
+static inline void __WFI(void) {}
+static inline void __WFE(void) {}
+static inline void __SEV(void) {}
+static inline void __ISB(void) {}
+static inline void __DSB(void) {}
+static inline void __DMB(void) {}
+
+static inline uint32_t __REV(uint32_t value) { return __builtin_bswap32(value); }
+static inline uint32_t __REV16(uint32_t value) { return ((value&0xff00ff00)>>8)|((value&0x00ff00ff)<<8); }
+static inline int32_t __REVSH(int32_t value) { return (int16_t)__builtin_bswap16(value); }
+static inline uint8_t __CLZ(uint32_t value) { return value?__builtin_clz(value):32; }
+
+static inline uint32_t __RBIT(uint32_t value)
+{
+	uint32_t r=0;
+	for(int i=0;i<32;++i,value>>=1)
+		r=(r<<1)|(value&1);
+	return r;
+}
+
+static inline int32_t host_ssat(int32_t value, int bits)
+{
+	int32_t max=(1<<(bits-1))-1;
+	return value>max?max:(value<-max-1?-max-1:value);
+}
+
+static inline int32_t host_usat(int32_t value, int bits)
+{
+	int32_t max=(int32_t)((1ULL<<bits)-1);
+	return value>max?max:(value<0?0:value);
+}
+
+#define __SSAT(ARG1,ARG2) host_ssat((ARG1),(ARG2))
+#define __USAT(ARG1,ARG2) host_usat((ARG1),(ARG2))
+
+// single threaded, nothing to exclude
+
+static inline uint8_t __LDREXB(volatile uint8_t *addr) { return *addr; }
+static inline uint16_t __LDREXH(volatile uint16_t *addr) { return *addr; }
+static inline uint32_t __LDREXW(volatile uint32_t *addr) { return *addr; }
+static inline uint32_t __STREXB(uint8_t value, volatile uint8_t *addr) { *addr=value; return 0; }
+static inline uint32_t __STREXH(uint16_t value, volatile uint16_t *addr) { *addr=value; return 0; }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr) { *addr=value; return 0; }
+static inline void __CLREX(void) {}
+
+static inline void __enable_irq(void) {}
+static inline void __disable_irq(void) {}
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t priMask) { (void)priMask; }
+static inline uint32_t __get_BASEPRI(void) { return 0; }
+static inline void __set_BASEPRI(uint32_t value) { (void)value; }
+
+#include_next <core_cm3.h>
+
+#endif
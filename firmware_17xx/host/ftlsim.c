@@ -0,0 +1,457 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: FTL simulator, runs fat/nor.c and fat/ftl.c over an in memory
+// W25Q (w25q_mock.c) to check the migration of pre-FTL volumes against power
+// cuts and to report the erase count distribution of a storage workload
+////////////////////////////////////////////////////////////////////////////////
+
+// usage: ftlsim <legacy image> <folder the image was built from> [save count] [hot presets]
+// legacy image: whole flash volume, as formatted before the FTL ("make legacy.img")
+
+// every boot runs in a fork()ed process: nor.c / ftl.c / FatFs start from
+// scratch like after a reset while the flash, in shared memory, stays
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "synth/synth.h"
+#include "synth/storage.h"
+#include "synth/seq.h"
+#include "diskio.h"
+#include "nor.h"
+#include "ftl.h"
+#include "rprintf.h"
+#include "w25q_mock.h"
+
+#define DEFAULT_SAVE_COUNT 5000
+#define DEFAULT_HOT_PRESETS 20 // users mostly tweak a few presets
+#define HOTTEST_COUNT 5
+#define HISTOGRAM_BUCKETS 12
+
+#define POOL_FIRST (W25Q_SECTOR_COUNT-FTL_RESERVED_SECTORS)
+#define LOG_FIRST (W25Q_SECTOR_COUNT-FTL_LOG_SECTORS)
+
+static FATFS fatFS;
+static const char * folder;
+static int hotPresets;
+
+// shared with the parent process
+static struct shared_s
+{
+	uint32_t noFtlErases[W25Q_SECTOR_COUNT]; // erases each logical sector would have needed without the FTL
+	uint16_t cutoff[PRESET_COUNT]; // last saved value, 0: never saved
+	int8_t sequencerSaved;
+	uint8_t sequencer[SEQ_NOTE_MEMORY];
+	struct nor_stats_s norStats; // save workload
+} * shared;
+
+static int putc_stdout(int c)
+{
+	return putchar(c);
+}
+
+static int putc_null(int c)
+{
+	return c;
+}
+
+// fat/diskio.c without the USB host drive
+
+DSTATUS disk_initialize(BYTE drv) { return nor_disk_initialize(); }
+DSTATUS disk_status(BYTE drv) { return nor_disk_status(); }
+DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, BYTE count) { return nor_disk_read(buff,sector,count); }
+DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, BYTE count) { return nor_disk_write(buff,sector,count); }
+DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void *buff) { return nor_disk_ioctl(ctrl,buff); }
+void disk_timerproc(void) {}
+
+uint32_t __real_ftl_writeSector(uint32_t sector, const uint8_t * buffer);
+
+uint32_t __wrap_ftl_writeSector(uint32_t sector, const uint8_t * buffer)
+{
+	// the current copy holds what the home sector would hold without the FTL
+	if(W25Q_compareSector(ftl_getPhysicalSector(sector),buffer)&W25Q_ERASE)
+		++shared->noFtlErases[sector];
+
+	return __real_ftl_writeSector(sector,buffer);
+}
+
+static int boot(void)
+{
+	FRESULT res;
+	DWORD freeClusters;
+	FATFS * fs;
+
+	if(disk_initialize(0))
+		return -1;
+
+	if((res=f_mount(0,&fatFS)) || (res=f_getfree("/",&freeClusters,&fs)))
+	{
+		printf("mount res=%d\n",res);
+		return -1;
+	}
+
+	// the volume must have left the FTL reserved sectors
+
+	if(fs->database+(fs->n_fatent-2)*fs->csize>POOL_FIRST)
+	{
+		printf("volume ends at sector %d\n",fs->database+(fs->n_fatent-2)*fs->csize);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int compareFile(const char * path, FILINFO * fno)
+{
+	static uint8_t expected[W25Q_SECTOR_SIZE],actual[W25Q_SECTOR_SIZE];
+	char hostPath[1024];
+	FILE * hf;
+	FIL f;
+	UINT br;
+	size_t hbr;
+	int ok=1;
+
+	snprintf(hostPath,sizeof(hostPath),"%s%s",folder,path);
+
+	if(!(hf=fopen(hostPath,"rb")))
+	{
+		perror(hostPath);
+		return 0;
+	}
+
+	if(f_open(&f,path,FA_READ|FA_OPEN_EXISTING))
+	{
+		fclose(hf);
+		return 0;
+	}
+
+	do
+	{
+		hbr=fread(expected,1,sizeof(expected),hf);
+		if(f_read(&f,actual,sizeof(actual),&br) || br!=hbr || memcmp(expected,actual,br))
+			ok=0;
+	}
+	while(ok && hbr);
+
+	f_close(&f);
+	fclose(hf);
+
+	if(!ok)
+		printf("%s differs\n",path);
+
+	return ok;
+}
+
+static int compareFolder(const char * path)
+{
+	DIR d;
+	FILINFO fno;
+	char lfn[_MAX_LFN+1];
+	char sub[1024];
+	int count=0,c;
+
+	fno.lfname=lfn;
+	fno.lfsize=sizeof(lfn);
+
+	if(f_opendir(&d,path))
+		return -1;
+
+	while(!f_readdir(&d,&fno) && fno.fname[0])
+	{
+		snprintf(sub,sizeof(sub),"%s/%s",path,lfn[0]?lfn:fno.fname);
+
+		if(fno.fattrib&AM_DIR)
+		{
+			if((c=compareFolder(sub))<0)
+				return -1;
+			count+=c;
+		}
+		else
+		{
+			if(!compareFile(sub,&fno))
+				return -1;
+			++count;
+		}
+	}
+
+	return count;
+}
+
+static int verifyContent(int verbose)
+{
+	int count;
+
+	if(boot())
+		return 1;
+
+	if((count=compareFolder(""))<=0)
+		return 1;
+
+	if(verbose)
+		printf("%d files identical\n",count);
+
+	return 0;
+}
+
+static int saveWorkload(int saveCount)
+{
+	uint8_t seq[SEQ_NOTE_MEMORY];
+
+	if(boot())
+		return 1;
+
+	settings_loadDefault();
+
+	// what the UI does: tweak and save a preset, remember it as current, sometimes save a sequence
+
+	for(int i=0;i<saveCount;++i)
+	{
+		uint16_t number=rand()%hotPresets;
+
+		preset_loadCurrent(number);
+		currentPreset->continuousParameters[cpCutoff]=1+rand()%UINT16_MAX;
+		preset_saveCurrent(number);
+		shared->cutoff[number]=currentPreset->continuousParameters[cpCutoff];
+
+		settings.presetNumber=number;
+		settings_save();
+
+		if(!(i%8))
+		{
+			for(int j=0;j<SEQ_NOTE_MEMORY;++j)
+				seq[j]=rand();
+			storage_saveSequencer(0,seq,SEQ_NOTE_MEMORY);
+			memcpy(shared->sequencer,seq,SEQ_NOTE_MEMORY);
+			shared->sequencerSaved=1;
+		}
+	}
+
+	nor_getStats(&shared->norStats);
+
+	return 0;
+}
+
+static int verifyWorkload(void)
+{
+	uint8_t seq[SEQ_NOTE_MEMORY];
+	int count=0;
+
+	if(boot())
+		return 1;
+
+	for(int n=0;n<PRESET_COUNT;++n)
+	{
+		if(!shared->cutoff[n])
+			continue;
+
+		if(!preset_loadCurrent(n) || currentPreset->continuousParameters[cpCutoff]!=shared->cutoff[n])
+		{
+			printf("preset %d lost\n",n);
+			return 1;
+		}
+
+		++count;
+	}
+
+	settings_loadDefault();
+
+	if(shared->sequencerSaved && (!storage_loadSequencer(0,seq,SEQ_NOTE_MEMORY) || memcmp(seq,shared->sequencer,SEQ_NOTE_MEMORY)))
+	{
+		printf("sequence lost\n");
+		return 1;
+	}
+
+	printf("%d presets and the sequence read back after reboot\n",count);
+
+	return 0;
+}
+
+static int run(int (*fn)(int), int param)
+{
+	pid_t pid;
+	int status;
+
+	fflush(stdout);
+
+	if(!(pid=fork()))
+		exit(fn(param));
+
+	waitpid(pid,&status,0);
+
+	return WIFEXITED(status)?WEXITSTATUS(status):-1;
+}
+
+static int bootOnly(int unused) { return boot(); }
+static int verifyWorkloadFn(int unused) { return verifyWorkload(); }
+
+static int migration(const char * image)
+{
+	int res;
+	uint32_t cut,ops;
+
+	// cut the power at each flash operation of the migration in turn, the next boot must recover
+
+	for(cut=1;;++cut)
+	{
+		if(w25q_mock_load(image))
+			return 1;
+
+		rprintf_devopen(0,putc_null); // only the result of each attempt
+
+		w25q_mock_setPowerCut(cut);
+		ops=w25q_mock_getOpCount();
+		res=run(bootOnly,0);
+		w25q_mock_setPowerCut(0);
+
+		if(res!=W25Q_MOCK_POWER_CUT_EXIT)
+			break;
+
+		res=run(verifyContent,0);
+
+		if(res)
+		{
+			printf("content lost after a power cut at operation %d\n",cut);
+			return 1;
+		}
+	}
+
+	rprintf_devopen(0,putc_stdout);
+
+	if(res)
+	{
+		printf("migration failed\n");
+		return 1;
+	}
+
+	printf("migration: %d flash operations, power cut at each of them recovered\n",w25q_mock_getOpCount()-ops);
+
+	return run(verifyContent,1);
+}
+
+static void histogram(const char * name, uint32_t first, uint32_t count, int8_t noFtl)
+{
+	uint32_t buckets[HISTOGRAM_BUCKETS]={0};
+	uint32_t min=UINT32_MAX,max=0,e,b;
+	uint64_t total=0;
+
+	for(uint32_t s=first;s<first+count;++s)
+	{
+		e=noFtl?shared->noFtlErases[s]:w25q_mock_getEraseCount(s);
+
+		min=MIN(min,e);
+		max=MAX(max,e);
+		total+=e;
+
+		// 0, 1, 2-3, 4-7, ...
+		for(b=0;b<HISTOGRAM_BUCKETS-1 && e>=(1u<<b);++b);
+		++buckets[b];
+	}
+
+	printf("%-20s %5d sectors erases min %6d max %6d mean %8.2f total %8lu\n",
+			name,count,min,max,(double)total/count,(unsigned long)total);
+
+	printf("%-20s ","");
+	for(b=0;b<HISTOGRAM_BUCKETS;++b)
+		if(buckets[b])
+		{
+			if(b<2)
+				printf(" %d:%d",b,buckets[b]);
+			else if(b==HISTOGRAM_BUCKETS-1)
+				printf(" >=%d:%d",1<<(b-1),buckets[b]);
+			else
+				printf(" %d-%d:%d",1<<(b-1),(1<<b)-1,buckets[b]);
+		}
+	printf("\n");
+}
+
+static void hottest(int8_t noFtl)
+{
+	uint32_t done[HOTTEST_COUNT];
+
+	printf("%-20s","hottest");
+
+	for(int i=0;i<HOTTEST_COUNT;++i)
+	{
+		uint32_t best=0,bestCount=0,e;
+
+		for(uint32_t s=0;s<W25Q_SECTOR_COUNT;++s)
+		{
+			int8_t seen=0;
+
+			for(int j=0;j<i;++j)
+				seen|=done[j]==s;
+
+			e=noFtl?shared->noFtlErases[s]:w25q_mock_getEraseCount(s);
+			if(!seen && e>bestCount)
+			{
+				best=s;
+				bestCount=e;
+			}
+		}
+
+		done[i]=best;
+		printf(" %d:%d",best,bestCount);
+	}
+
+	printf("\n");
+}
+
+int main(int argc, char ** argv)
+{
+	int saveCount;
+
+	if(argc<3)
+	{
+		fprintf(stderr,"usage: %s <legacy image> <folder the image was built from> [save count] [hot presets]\n",argv[0]);
+		return 1;
+	}
+
+	folder=argv[2];
+	saveCount=(argc>3)?atoi(argv[3]):DEFAULT_SAVE_COUNT;
+	hotPresets=(argc>4)?MIN(atoi(argv[4]),PRESET_COUNT):DEFAULT_HOT_PRESETS;
+
+	rprintf_devopen(0,putc_stdout);
+
+	w25q_mock_init();
+
+	shared=mmap(NULL,sizeof(struct shared_s),PROT_READ|PROT_WRITE,MAP_SHARED|MAP_ANONYMOUS,-1,0);
+	if(shared==MAP_FAILED)
+	{
+		perror("mmap");
+		return 1;
+	}
+	memset(shared,0,sizeof(struct shared_s));
+
+	if(migration(argv[1]))
+		return 1;
+
+	// wear
+
+	w25q_mock_resetEraseCounts();
+
+	if(run(saveWorkload,saveCount) || run(verifyWorkloadFn,0))
+		return 1;
+
+	printf("\n%d preset saves (%d hot presets), as many settings saves, %d sequencer saves\n\n",
+			saveCount,hotPresets,(saveCount+7)/8);
+
+	printf("disk writes %lu sectors: %lu unchanged, %lu programmed in place without an erase, %lu relocated, %lu erased in place\n\n",
+			(unsigned long)shared->norStats.writes,(unsigned long)shared->norStats.unchanged,
+			(unsigned long)shared->norStats.erasesAvoided,(unsigned long)shared->norStats.relocations,
+			(unsigned long)shared->norStats.erases);
+
+	printf("with the FTL\n");
+	histogram("data",0,POOL_FIRST,0);
+	histogram("pool",POOL_FIRST,FTL_POOL_SECTORS,0);
+	histogram("log",LOG_FIRST,FTL_LOG_SECTORS,0);
+	hottest(0);
+
+	printf("\nwithout the FTL, same writes\n");
+	histogram("data",0,POOL_FIRST,1);
+	hottest(1);
+
+	return 0;
+}
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: DMA IRQ cost benchmark, the work DMA_IRQHandler does (CVs,
+// oscillators, 500Hz tick) with the image's current preset, idle, every voice
+// playing, then with both per-voice LFOs, built once per voice count (see Makefile)
+////////////////////////////////////////////////////////////////////////////////
+
+// usage: irqbench <image>
+// the image is modified (wave indexes), use a copy
+// host time, not target cycles: the growth with the voice count is what counts,
+// dacspi_getIRQLoad() gives the real load on the target (DEBUG builds)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+
+#include "synth/synth.h"
+#include "synth/storage.h"
+#include "synth/assigner.h"
+#include "synth/dacspi.h"
+#include "diskio_host.h"
+
+#define IRQ_COUNT 20000
+#define RUNS 5 // best of
+#define IDLE_UPDATES 1000
+#define FIRST_NOTE 48
+#define IRQ_HZ (TICKER_HZ*4) // synth_tickTimerEvent() phases
+
+static FATFS fatFS;
+
+static int putc_null(int c)
+{
+	return c;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec*1e9+ts.tv_nsec;
+}
+
+// DMA_IRQHandler without the hardware access, see dacspi.c
+static void dmaIRQ(int irq)
+{
+	int32_t set=(irq&1)?0:DACSPI_BUFFER_COUNT/2;
+
+	synth_updateCVsEvent();
+	synth_updateOscsEvent(set,DACSPI_BUFFER_COUNT/4);
+
+	set+=DACSPI_CV_COUNT;
+	synth_updateCVsEvent();
+	synth_updateOscsEvent(set,DACSPI_BUFFER_COUNT/4);
+
+	synth_tickTimerEvent(irq&3);
+}
+
+static double measure(void)
+{
+	double start,best=INFINITY;
+	int irq=0;
+
+	for(int r=0;r<RUNS;++r)
+	{
+		start=now();
+		for(int i=0;i<IRQ_COUNT;++i)
+			dmaIRQ(irq++);
+		best=fmin(best,(now()-start)/IRQ_COUNT);
+	}
+
+	return best;
+}
+
+static void report(const char * state)
+{
+	double ns=measure();
+
+	printf("%2d voices, %-24s %6.0f ns/IRQ, %4.0f ns/voice, %5.2f%% of a host core at %dHz\n",
+			SYNTH_VOICE_COUNT,state,ns,ns/SYNTH_VOICE_COUNT,ns*IRQ_HZ*1e-7,IRQ_HZ);
+}
+
+int main(int argc, char ** argv)
+{
+	FRESULT res;
+
+	if(argc<2)
+	{
+		fprintf(stderr,"usage: %s <image>\n",argv[0]);
+		return 1;
+	}
+
+	rprintf_devopen(0,putc_null);
+	rprintf_devopen(1,putc_null); // LCD
+
+	if(diskio_host_open(argv[1]))
+		return 1;
+
+	if((res=f_mount(0,&fatFS)))
+	{
+		fprintf(stderr,"f_mount res=%d\n",res);
+		return 1;
+	}
+
+	synth_init();
+
+	// let the main loop load the waves
+	for(int i=0;i<IDLE_UPDATES;++i)
+	{
+		synth_update();
+		dmaIRQ(i);
+	}
+
+	// whatever the preset, poly on every voice
+
+	currentPreset->steppedParameters[spVoiceCount]=SYNTH_VOICE_COUNT-1;
+	currentPreset->steppedParameters[spUnison]=0;
+	for(int v=0;v<SYNTH_VOICE_COUNT;++v)
+		currentPreset->voicePattern[v]=(v==0)?0:ASSIGNER_NO_NOTE;
+	synth_refreshFullState(0);
+
+	report("idle");
+
+	for(int v=0;v<SYNTH_VOICE_COUNT;++v)
+		assigner_assignNote(FIRST_NOTE+v,1,UINT16_MAX,0);
+
+	report("all playing");
+
+	currentPreset->steppedParameters[spLFOPerVoice]=1;
+	currentPreset->steppedParameters[spLFO2PerVoice]=1;
+	synth_refreshFullState(0);
+
+	report("all playing, voice LFOs");
+
+	f_mount(0,NULL);
+	diskio_host_close();
+
+	return 0;
+}
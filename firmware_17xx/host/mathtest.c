@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: fixed point math test, exp2NegFixed() / exponentialCourse() and
+// scan_potTo16bits() / scan_potFrom16bits() against the float versions they
+// replaced (expf / roundf) and the exact values, over their whole input range
+////////////////////////////////////////////////////////////////////////////////
+
+// usage: mathtest
+// exit status is non zero when an error bound below is exceeded
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "synth/utils.h"
+#include "synth/scan.h"
+
+// error bounds, in output LSBs
+#define EXP2NEG_MAX_ERROR 2.0 // 65535*2^-x, table interpolation + truncation
+#define COURSE_MAX_ERROR 1 // vs the expf() exponentialCourse(), at its call sites (synth.c)
+#define POT_MAX_ERROR 0 // vs exact rounding
+#define POT_MAX_FLOAT_ERROR 1 // vs the roundf() versions, float precision
+
+volatile uint32_t currentTick; // synth.c isn't linked
+
+static int errors;
+
+static void check(const char * name, double maxError, double bound)
+{
+	int ok=maxError<=bound;
+
+	printf("%-44s max error %8.4f, bound %6.2f %s\n",name,maxError,bound,ok?"ok":"EXCEEDED");
+
+	if(!ok)
+		++errors;
+}
+
+static void testExp2Neg(void)
+{
+	double maxError=0.0,maxRelError=0.0,e,d;
+	uint16_t v;
+
+	// whole useful range, results are 0 from 2^-16 on
+
+	for(uint32_t x=0;x<(16<<16);++x)
+	{
+		v=exp2NegFixed(x,UINT16_MAX);
+		e=UINT16_MAX*exp2(-(double)x/65536.0);
+		d=fabs(v-e);
+
+		maxError=fmax(maxError,d);
+		if(e>=256.0) // below, truncation dominates
+			maxRelError=fmax(maxRelError,d/e);
+	}
+
+	check("exp2NegFixed(x,65535) vs 65535*2^-x",maxError,EXP2NEG_MAX_ERROR);
+	printf("%-44s max relative error %.2e above 256\n","",maxRelError);
+}
+
+// old synth.c code
+static uint16_t exponentialCourseFloat(uint16_t v, float ratio, float range)
+{
+	return expf(-(float)v/ratio)*range;
+}
+
+static void testExponentialCourse(void)
+{
+	int maxError[2]={0,0};
+	int mismatches[2]={0,0};
+	int d;
+
+	for(uint32_t v=0;v<=UINT16_MAX;++v)
+	{
+		// same constants as synth.c
+		d=abs(exponentialCourse(v,12000.0f,2500.0f)-exponentialCourseFloat(v,12000.0f,2500.0f));
+		maxError[0]=MAX(maxError[0],d);
+		mismatches[0]+=d!=0;
+
+		d=abs(exponentialCourse(v,11000.0f,2100.0f)-exponentialCourseFloat(v,11000.0f,2100.0f));
+		maxError[1]=MAX(maxError[1],d);
+		mismatches[1]+=d!=0;
+	}
+
+	check("exponentialCourse(v,12000,2500) vs expf()",maxError[0],COURSE_MAX_ERROR);
+	printf("%-44s %d of 65536 inputs differ\n","",mismatches[0]);
+	check("exponentialCourse(v,11000,2100) vs expf()",maxError[1],COURSE_MAX_ERROR);
+	printf("%-44s %d of 65536 inputs differ\n","",mismatches[1]);
+}
+
+static void testPot(const char * name, int (*fn)(int), int max, double mul, double div)
+{
+	int maxError=0,maxFloatError=0,floatMismatches=0,v,d;
+
+	for(int x=-max;x<=max;++x)
+	{
+		v=fn(x);
+
+		// exact: round half away from zero
+		d=abs(v-(int)round(x*mul/div));
+		maxError=MAX(maxError,d);
+
+		// old code
+		d=abs(v-(int)roundf((((float)x)*(float)mul)/(float)div));
+		maxFloatError=MAX(maxFloatError,d);
+		floatMismatches+=d!=0;
+	}
+
+	check(name,maxError,POT_MAX_ERROR);
+	printf("%-44s vs roundf() version: max %d, %d of %d inputs differ\n","",maxFloatError,floatMismatches,2*max+1);
+	if(maxFloatError>POT_MAX_FLOAT_ERROR)
+		++errors;
+}
+
+int main(int argc, char ** argv)
+{
+	testExp2Neg();
+	testExponentialCourse();
+	testPot("scan_potTo16bits(x) vs exact rounding",scan_potTo16bits,SCAN_POT_MAX_VALUE,UINT16_MAX,SCAN_POT_MAX_VALUE);
+	testPot("scan_potFrom16bits(x) vs exact rounding",scan_potFrom16bits,UINT16_MAX,SCAN_POT_MAX_VALUE,UINT16_MAX);
+
+	printf("%s\n",errors?"FAILED":"passed");
+
+	return errors?1:0;
+}
@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: NOR disk image from folders of the PC, formatted like the synth
+// does it, see main.c
+////////////////////////////////////////////////////////////////////////////////
+
+// usage: mkimage <image> <sector count> <folder>...
+// each folder is copied recursively to the root of the image
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// FatFs and POSIX both have a DIR type
+#define DIR FATFS_DIR
+#include "ff.h"
+#undef DIR
+
+#include "diskio_host.h"
+#include "w25q.h"
+
+static FATFS fatFS;
+static uint8_t buffer[W25Q_SECTOR_SIZE];
+
+static int copyFile(const char * src, const char * dst)
+{
+	FILE * in;
+	FIL out;
+	size_t br;
+	UINT bw;
+	FRESULT res;
+	
+	if(!(in=fopen(src,"rb")))
+	{
+		perror(src);
+		return -1;
+	}
+
+	if((res=f_open(&out,dst,FA_WRITE|FA_CREATE_ALWAYS)))
+	{
+		fprintf(stderr,"%s: f_open res=%d\n",dst,res);
+		fclose(in);
+		return -1;
+	}
+	
+	while((br=fread(buffer,1,sizeof(buffer),in))>0)
+		if((res=f_write(&out,buffer,br,&bw)) || bw!=br)
+		{
+			fprintf(stderr,"%s: f_write res=%d (disk full?)\n",dst,res);
+			break;
+		}
+
+	f_close(&out);
+	fclose(in);
+	
+	return res?-1:0;
+}
+
+static int copyFolder(const char * src, const char * dst)
+{
+	DIR * d;
+	struct dirent * de;
+	struct stat st;
+	char s[1024],t[1024];
+	int res=0;
+	
+	if(!(d=opendir(src)))
+	{
+		perror(src);
+		return -1;
+	}
+	
+	f_mkdir(dst);
+	
+	while(!res && (de=readdir(d)))
+	{
+		if(de->d_name[0]=='.')
+			continue;
+		
+		snprintf(s,sizeof(s),"%s/%s",src,de->d_name);
+		snprintf(t,sizeof(t),"%s/%s",dst,de->d_name);
+		
+		if(stat(s,&st))
+			continue;
+		
+		if(S_ISDIR(st.st_mode))
+			res=copyFolder(s,t);
+		else
+			res=copyFile(s,t);
+	}
+
+	closedir(d);
+	
+	return res;
+}
+
+int main(int argc, char ** argv)
+{
+	FILE * f;
+	FRESULT res;
+	long sectorCount;
+	const char * name;
+	char dst[1024];
+	
+	if(argc<3)
+	{
+		fprintf(stderr,"usage: %s <image> <sector count> <folder>...\n",argv[0]);
+		return 1;
+	}
+	
+	sectorCount=atol(argv[2]);
+	
+	// blank flash reads as 0xff
+	
+	if(!(f=fopen(argv[1],"wb")))
+	{
+		perror(argv[1]);
+		return 1;
+	}
+
+	memset(buffer,0xff,sizeof(buffer));
+	for(long i=0;i<sectorCount;++i)
+		fwrite(buffer,sizeof(buffer),1,f);
+	fclose(f);
+	
+	if(diskio_host_open(argv[1]))
+		return 1;
+	
+	if((res=f_mount(0,&fatFS)) || (res=f_mkfs(0,0,0)))
+	{
+		fprintf(stderr,"f_mkfs res=%d\n",res);
+		return 1;
+	}
+
+	for(int i=3;i<argc;++i)
+	{
+		name=strrchr(argv[i],'/');
+		name=name?name+1:argv[i];
+		snprintf(dst,sizeof(dst),"/%s",name);
+		
+		if(copyFolder(argv[i],dst))
+			return 1;
+	}
+	
+	f_mount(0,NULL);
+	diskio_host_close();
+	
+	return 0;
+}
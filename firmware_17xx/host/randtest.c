@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: LFO random sources test, lfsr() jump ahead against the bitwise
+// loop it replaced (same values, same period) and the distribution of the
+// xorshift lsRand values
+////////////////////////////////////////////////////////////////////////////////
+
+// usage: randtest [period]
+// "period" also walks the whole LFSR cycle, bitwise and jumping ahead by some
+// lsNoise step counts, about 45s
+// exit status is non zero on failure
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "synth/utils.h"
+#include "synth/lfo.h"
+
+#define COMPARE_COUNT 1000000
+#define HISTOGRAM_BUCKETS 64
+#define DRAWS_PER_LFO (1<<20)
+#define LFO_COUNT (2+2*SYNTH_VOICE_COUNT) // see synth.c
+#define CHI2_LIMIT 110.0 // 63 degrees of freedom, p=0.0002
+
+volatile uint32_t currentTick; // synth.c isn't linked
+
+// lfsr() before the jump ahead, one bit per step
+static uint32_t lfsrBitwise(uint32_t v, uint8_t taps)
+{
+	uint8_t b24;
+
+	while(taps--)
+	{
+		b24=v>>24;
+
+		v<<=1;
+		v|=((b24>>7)^(b24>>5)^(b24>>1)^b24)&1;
+	}
+
+	return v;
+}
+
+static int compareLfsr(void)
+{
+	uint32_t v;
+	int errors=0;
+
+	for(int i=0;i<COMPARE_COUNT;++i)
+	{
+		v=(rand()<<16)^rand();
+
+		for(int taps=0;taps<=UINT8_MAX;taps+=(taps<48)?1:29)
+			if(lfsr(v,taps)!=lfsrBitwise(v,taps))
+			{
+				if(!errors)
+					printf("lfsr(%08x,%d)=%08x, bitwise %08x\n",v,taps,lfsr(v,taps),lfsrBitwise(v,taps));
+				++errors;
+			}
+	}
+
+	printf("lfsr jump ahead vs bitwise: %d random values, 0..255 steps, %d mismatches\n",COMPARE_COUNT,errors);
+
+	return errors;
+}
+
+static uint64_t period(uint32_t (*fn)(uint32_t,uint8_t), uint8_t taps)
+{
+	uint32_t v=1;
+	uint64_t n=0;
+
+	do
+	{
+		v=fn(v,taps);
+		++n;
+	}
+	while(v!=1 && n<(1ULL<<33));
+
+	return n;
+}
+
+static uint64_t gcd(uint64_t a, uint64_t b)
+{
+	return b?gcd(b,a%b):a;
+}
+
+static int comparePeriods(void)
+{
+	static const uint8_t steps[]={1,3,16}; // lsNoise does 1 to 16, 3 divides 2^32-1
+	const uint64_t maximal=UINT32_MAX; // every non zero value
+	uint64_t p,q;
+	int errors=0;
+
+	p=period(lfsrBitwise,1);
+	printf("period bitwise: %llu%s\n",(unsigned long long)p,(p==maximal)?", maximal":"");
+	errors+=p!=maximal;
+
+	// k steps at once: the same cycle, visited p/gcd(p,k) times
+
+	for(int i=0;i<sizeof(steps);++i)
+	{
+		q=period(lfsr,steps[i]);
+		printf("period jump ahead, %2d steps: %llu updates, expected %llu\n",steps[i],
+				(unsigned long long)q,(unsigned long long)(p/gcd(p,steps[i])));
+		errors+=q!=p/gcd(p,steps[i]);
+	}
+
+	return errors;
+}
+
+static int histogram(void)
+{
+	struct lfo_s lfos[LFO_COUNT];
+	uint32_t buckets[HISTOGRAM_BUCKETS];
+	double chi2,expected,worst=0.0;
+	int errors=0;
+
+	for(int l=0;l<LFO_COUNT;++l)
+		lfo_init(&lfos[l]);
+
+	for(int l=0;l<LFO_COUNT;++l)
+	{
+		struct lfo_s * lfo=&lfos[l];
+
+		if(!lfo->noise)
+			++errors;
+
+		for(int m=0;m<l;++m)
+			if(lfos[m].noise==lfo->noise)
+				++errors;
+
+		lfo_setShape(lfo,lsRand,0);
+		lfo_setCVs(lfo,UINT16_MAX,UINT16_MAX);
+
+		memset(buckets,0,sizeof(buckets));
+
+		// lsRand only takes a new value at the start of a period
+
+		for(int i=0;i<DRAWS_PER_LFO;++i)
+		{
+			lfo_reset(lfo);
+			lfo_update(lfo);
+			++buckets[(lfo->noise&UINT16_MAX)*HISTOGRAM_BUCKETS>>16];
+		}
+
+		expected=(double)DRAWS_PER_LFO/HISTOGRAM_BUCKETS;
+		chi2=0.0;
+		for(int b=0;b<HISTOGRAM_BUCKETS;++b)
+			chi2+=(buckets[b]-expected)*(buckets[b]-expected)/expected;
+
+		worst=fmax(worst,chi2);
+		if(chi2>CHI2_LIMIT)
+		{
+			printf("lfo %d: chi2 %.1f\n",l,chi2);
+			++errors;
+		}
+	}
+
+	printf("xorshift lsRand: %d LFOs, distinct non zero seeds, %d values each in %d buckets, worst chi2 %.1f (limit %.1f)\n",
+			LFO_COUNT,DRAWS_PER_LFO,HISTOGRAM_BUCKETS,worst,CHI2_LIMIT);
+
+	return errors;
+}
+
+int main(int argc, char ** argv)
+{
+	int errors=0;
+
+	errors+=compareLfsr();
+	errors+=histogram();
+
+	if(argc>1 && !strcmp(argv[1],"period"))
+		errors+=comparePeriods();
+
+	printf("%s\n",errors?"FAILED":"passed");
+
+	return errors?1:0;
+}
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: wave resampler benchmark, speed and error of rmSinc vs rmHermite
+// for the source sizes the wave loader sees, against the exact band limited
+// wave, and in place vs out of place equality (the loader works in place)
+////////////////////////////////////////////////////////////////////////////////
+
+// the output may lag by a fraction of a source sample, a phase shift that
+// doesn't matter for a single cycle wave, the error is measured after removing
+// it, so it is the interpolation / imaging error only
+
+// usage: resbench
+// exit status is non zero when in place output differs
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "synth/utils.h"
+#include "synth/wtosc.h"
+
+#define BENCH_CALLS 2000
+#define AMPLITUDE 30000.0
+#define SLOT_SIZE (WTOSC_SAMPLE_COUNT+RESAMPLE_SINC_TAPS/2)
+
+static uint16_t slot[SLOT_SIZE];
+static uint16_t src[WTOSC_SAMPLE_COUNT];
+static uint16_t dst[WTOSC_SAMPLE_COUNT];
+static const char * modeNames[]={"hermite","sinc"};
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec*1e6+ts.tv_nsec*1e-3;
+}
+
+// one cycle, harmonics 1/h from first to last (sine when first==last)
+static double wave(double x, int first, int last)
+{
+	double v=0.0,norm=0.0;
+
+	for(int h=first;h<=last;++h)
+	{
+		v+=sin(2.0*M_PI*h*x)/h;
+		norm+=1.0/h;
+	}
+
+	return 32768.0+AMPLITUDE*v/norm;
+}
+
+static double snr(uint16_t srcCnt, resampleMode_t mode, double lag, int first, int last)
+{
+	double signal=0.0,noise=0.0,e;
+
+	for(int i=0;i<srcCnt;++i)
+		src[i]=lrint(wave((double)i/srcCnt,first,last));
+
+	resample(src,dst,srcCnt,WTOSC_SAMPLE_COUNT,mode);
+
+	for(int i=0;i<WTOSC_SAMPLE_COUNT;++i)
+	{
+		e=wave((double)i/WTOSC_SAMPLE_COUNT-lag/srcCnt,first,last);
+		signal+=(e-32768.0)*(e-32768.0);
+		noise+=(dst[i]-e)*(dst[i]-e);
+	}
+
+	return 10.0*log10(signal/noise);
+}
+
+static double measureLag(uint16_t srcCnt, resampleMode_t mode)
+{
+	double best=0.0,bestError=INFINITY,error,e;
+
+	// fundamental only, the lag is the shift that fits best
+
+	for(int i=0;i<srcCnt;++i)
+		src[i]=lrint(wave((double)i/srcCnt,1,1));
+
+	resample(src,dst,srcCnt,WTOSC_SAMPLE_COUNT,mode);
+
+	for(double l=-2.0;l<=2.0;l+=1.0/64)
+	{
+		error=0.0;
+		for(int i=0;i<WTOSC_SAMPLE_COUNT;++i)
+		{
+			e=wave((double)i/WTOSC_SAMPLE_COUNT-l/srcCnt,1,1);
+			error+=(dst[i]-e)*(dst[i]-e);
+		}
+
+		if(error<bestError)
+		{
+			best=l;
+			bestError=error;
+		}
+	}
+
+	return best;
+}
+
+static double speed(uint16_t srcCnt, resampleMode_t mode)
+{
+	double start;
+
+	for(int i=0;i<srcCnt;++i)
+		src[i]=rand();
+
+	// in place, like the loader
+	start=now();
+	for(int c=0;c<BENCH_CALLS;++c)
+	{
+		memcpy(&slot[SLOT_SIZE-srcCnt],src,srcCnt*sizeof(uint16_t));
+		resample(&slot[SLOT_SIZE-srcCnt],slot,srcCnt,WTOSC_SAMPLE_COUNT,mode);
+	}
+
+	return (now()-start)/BENCH_CALLS;
+}
+
+static int inPlaceErrors(resampleMode_t mode)
+{
+	int errors=0;
+
+	for(int srcCnt=2;srcCnt<=WTOSC_SAMPLE_COUNT;++srcCnt)
+	{
+		for(int i=0;i<srcCnt;++i)
+			src[i]=rand();
+
+		resample(src,dst,srcCnt,WTOSC_SAMPLE_COUNT,mode);
+
+		memcpy(&slot[SLOT_SIZE-srcCnt],src,srcCnt*sizeof(uint16_t));
+		resample(&slot[SLOT_SIZE-srcCnt],slot,srcCnt,WTOSC_SAMPLE_COUNT,mode);
+
+		if(memcmp(slot,dst,sizeof(dst)))
+		{
+			printf("%s: in place differs for %d samples\n",modeNames[mode],srcCnt);
+			++errors;
+		}
+	}
+
+	return errors;
+}
+
+int main(int argc, char ** argv)
+{
+	static const uint16_t sizes[]={256,600,1024,2048};
+	int errors=0;
+
+	printf("%d samples out, SNR against the exact wave in dB, time per call in us\n\n",WTOSC_SAMPLE_COUNT);
+	printf("%6s %8s %8s %10s %10s %10s %10s\n","in","mode","lag","sine .36","sine .62","saw","us/call");
+
+	for(int s=0;s<sizeof(sizes)/sizeof(sizes[0]);++s)
+	{
+		uint16_t n=sizes[s];
+
+		for(resampleMode_t mode=rmHermite;mode<=rmSinc;++mode)
+		{
+			double lag=measureLag(n,mode);
+
+			printf("%6d %8s %8.2f %10.1f %10.1f %10.1f %10.1f\n",n,modeNames[mode],lag,
+					snr(n,mode,lag,lrint(0.36*n/2),lrint(0.36*n/2)),
+					snr(n,mode,lag,lrint(0.62*n/2),lrint(0.62*n/2)),
+					snr(n,mode,lag,1,n/2-1), // up to the source nyquist
+					speed(n,mode));
+		}
+	}
+
+	for(resampleMode_t mode=rmHermite;mode<=rmSinc;++mode)
+		errors+=inPlaceErrors(mode);
+
+	printf("\nin place vs out of place: %s\n",errors?"DIFFERS":"identical for every source size");
+
+	return errors?1:0;
+}
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: hardware facing functions the synth code calls, as no-ops
+////////////////////////////////////////////////////////////////////////////////
+
+// scan.c and dacspi.c are linked for their computations, their hardware
+// init/update functions are replaced at link time (-Wl,--wrap), see Makefile
+
+#include "synth/synth.h"
+#include "synth/ui.h"
+#include "synth/midi.h"
+#include "synth/uart_midi.h"
+
+#include "lpc177x_8x_gpio.h"
+#include "lpc177x_8x_pinsel.h"
+#include "lpc177x_8x_ssp.h"
+#include "lpc177x_8x_timer.h"
+#include "lpc177x_8x_clkpwr.h"
+
+#include "usb/msc_scsi.h"
+#include "w25q.h"
+
+// drivers
+
+uint32_t GPIO_ReadValue(uint8_t portNum) { return UINT32_MAX; } // pulled up inputs
+void GPIO_SetDir(uint8_t portNum, uint32_t bitValue, uint8_t dir) {}
+void GPIO_SetValue(uint8_t portNum, uint32_t bitValue) {}
+void GPIO_ClearValue(uint8_t portNum, uint32_t bitValue) {}
+PINSEL_RET_CODE PINSEL_ConfigPin(uint8_t portnum, uint8_t pinnum, uint8_t funcnum) { return PINSEL_RET_OK; }
+PINSEL_RET_CODE PINSEL_SetOpenDrainMode(uint8_t portnum, uint8_t pinnum, FunctionalState NewState) { return PINSEL_RET_OK; }
+PINSEL_RET_CODE PINSEL_SetPinMode(uint8_t portnum, uint8_t pinnum, PinSel_BasicMode modenum) { return PINSEL_RET_OK; }
+void SSP_Cmd(LPC_SSP_TypeDef* SSPx, FunctionalState NewState) {}
+void SSP_ConfigStructInit(SSP_CFG_Type *SSP_InitStruct) {}
+FlagStatus SSP_GetStatus(LPC_SSP_TypeDef* SSPx, uint32_t FlagType) { return RESET; }
+void SSP_Init(LPC_SSP_TypeDef *SSPx, SSP_CFG_Type *SSP_ConfigStruct) {}
+int32_t SSP_ReadWrite (LPC_SSP_TypeDef *SSPx, SSP_DATA_SETUP_Type *dataCfg, SSP_TRANSFER_Type xfType) { return 0; }
+uint16_t SSP_ReceiveData(LPC_SSP_TypeDef* SSPx) { return 0; }
+void SSP_SendData(LPC_SSP_TypeDef* SSPx, uint16_t Data) {}
+void SSP_DMACmd(LPC_SSP_TypeDef *SSPx, uint32_t DMAMode, FunctionalState NewState) {}
+void TIM_ClearIntPending(LPC_TIM_TypeDef *TIMx, TIM_INT_TYPE IntFlag) {}
+void TIM_Cmd(LPC_TIM_TypeDef *TIMx, FunctionalState NewState) {}
+void TIM_ConfigMatch(LPC_TIM_TypeDef *TIMx, TIM_MATCHCFG_Type *TIM_MatchConfigStruct) {}
+void TIM_Init(LPC_TIM_TypeDef *TIMx, TIM_MODE_OPT TimerCounterMode, void *TIM_ConfigStruct) {}
+void CLKPWR_ConfigPPWR(uint32_t PPType, FunctionalState NewState) {}
+
+uint32_t SystemCoreClock=120000000;
+
+void delay_us(uint32_t count) {}
+void delay_ms(uint32_t count) {}
+
+// wrapped synth modules
+
+void __wrap_scan_init(void) {}
+void __wrap_scan_update(void) {}
+void __wrap_dacspi_init(void) {}
+
+// modules left out
+
+void ui_update(void) {}
+void ui_setPresetModified(int8_t modified) {}
+
+void midi_init(void) {}
+void midi_update(void) {}
+void midi_processInput(void) {}
+void midi_newData(midiPort_t port, uint8_t data) {}
+
+void uartMidi_init(void) {}
+
+void usb_setMode(usbMode_t mode, usb_MSC_continue_callback_t usbMSCContinue) {}
+
+U8 * SCSIGetBlockBuffer(void)
+{
+	static U8 blockBuffer[W25Q_SECTOR_SIZE];
+	return blockBuffer;
+}
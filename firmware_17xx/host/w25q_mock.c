@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host build: W25Q NOR flash in memory, with its write rules (programming only
+// clears bits, one page at a time), erase counts and power cuts
+////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "w25q_mock.h"
+
+static struct mock_s
+{
+	uint8_t data[W25Q_SECTOR_COUNT*W25Q_SECTOR_SIZE];
+	uint32_t erases[W25Q_SECTOR_COUNT];
+	uint32_t ops;
+	uint32_t powerCutOps;
+} * mock;
+
+static void operation(void)
+{
+	++mock->ops;
+	
+	if(mock->powerCutOps && mock->ops>=mock->powerCutOps)
+		_exit(W25Q_MOCK_POWER_CUT_EXIT); // this operation never happens
+}
+
+void w25q_mock_init(void)
+{
+	mock=mmap(NULL,sizeof(struct mock_s),PROT_READ|PROT_WRITE,MAP_SHARED|MAP_ANONYMOUS,-1,0);
+	if(mock==MAP_FAILED)
+	{
+		perror("mmap");
+		exit(1);
+	}
+	
+	memset(mock->data,0xff,sizeof(mock->data));
+}
+
+int w25q_mock_load(const char * image)
+{
+	FILE * f;
+	
+	if(!(f=fopen(image,"rb")))
+	{
+		perror(image);
+		return -1;
+	}
+	
+	memset(mock->data,0xff,sizeof(mock->data));
+	if(!fread(mock->data,1,sizeof(mock->data),f))
+		fprintf(stderr,"%s: empty\n",image);
+	fclose(f);
+	
+	return 0;
+}
+
+void w25q_mock_setPowerCut(uint32_t afterOps)
+{
+	mock->powerCutOps=afterOps?mock->ops+afterOps:0;
+}
+
+uint32_t w25q_mock_getOpCount(void)
+{
+	return mock->ops;
+}
+
+uint32_t w25q_mock_getEraseCount(uint32_t index)
+{
+	return mock->erases[index];
+}
+
+void w25q_mock_resetEraseCounts(void)
+{
+	memset(mock->erases,0,sizeof(mock->erases));
+}
+
+// w25q.h
+
+int8_t W25Q_init(void)
+{
+	return 0;
+}
+
+void W25Q_read(uint32_t address, uint8_t * buffer, uint32_t size)
+{
+	if(address+size>sizeof(mock->data))
+	{
+		fprintf(stderr,"W25Q_read out of flash %x\n",address);
+		abort();
+	}
+	
+	memcpy(buffer,&mock->data[address],size);
+}
+
+void W25Q_readSectors(uint32_t index, uint32_t count, uint8_t * buffer)
+{
+	W25Q_read(index<<W25Q_SECTOR_BITS,buffer,count<<W25Q_SECTOR_BITS);
+}
+
+void W25Q_readSector(uint32_t index, uint8_t * buffer)
+{
+	W25Q_readSectors(index,1,buffer);
+}
+
+void W25Q_program(uint32_t address, const uint8_t * buffer, uint32_t size)
+{
+	if((address&W25Q_PAGE_MASK)+size>W25Q_PAGE_SIZE || address+size>sizeof(mock->data))
+	{
+		fprintf(stderr,"W25Q_program across a page %x %d\n",address,size);
+		abort();
+	}
+
+	operation();
+	
+	for(uint32_t i=0;i<size;++i)
+		mock->data[address+i]&=buffer[i];
+}
+
+void W25Q_eraseSector(uint32_t index)
+{
+	if(index>=W25Q_SECTOR_COUNT)
+	{
+		fprintf(stderr,"W25Q_eraseSector out of flash %d\n",index);
+		abort();
+	}
+
+	operation();
+	
+	memset(&mock->data[index<<W25Q_SECTOR_BITS],0xff,W25Q_SECTOR_SIZE);
+	++mock->erases[index];
+}
+
+uint32_t W25Q_compareSector(uint32_t index, const uint8_t * buffer)
+{
+	const uint8_t * page=&mock->data[index<<W25Q_SECTOR_BITS];
+	uint32_t changed=0,used=0,erase=0;
+	
+	// same rules as w25q.c
+
+	for(int p=0;p<W25Q_PAGES_PER_SECTOR;++p)
+	{
+		for(int i=0;i<W25Q_PAGE_SIZE;++i)
+		{
+			uint8_t b=buffer[i];
+
+			if(b!=0xff)
+				used|=1<<p;
+
+			if(b!=page[i])
+			{
+				changed|=1<<p;
+
+				if(b&~page[i])
+					erase=W25Q_ERASE;
+			}
+		}
+
+		buffer+=W25Q_PAGE_SIZE;
+		page+=W25Q_PAGE_SIZE;
+	}
+	
+	return erase?(erase|used):changed;
+}
+
+void W25Q_programSector(uint32_t index, const uint8_t * buffer, uint32_t pages)
+{
+	if(pages&W25Q_ERASE)
+		W25Q_eraseSector(index);
+	
+	for(int p=0;p<W25Q_PAGES_PER_SECTOR;++p)
+		if(pages&(1<<p))
+			W25Q_program((index<<W25Q_SECTOR_BITS)+(p<<W25Q_PAGE_BITS),&buffer[p<<W25Q_PAGE_BITS],W25Q_PAGE_SIZE);
+}
+
+void W25Q_writeSector(uint32_t index, const uint8_t * buffer)
+{
+	W25Q_programSector(index,buffer,W25Q_ERASE|W25Q_ALL_PAGES);
+}
@@ -0,0 +1,15 @@
+#ifndef W25Q_MOCK_H
+#define W25Q_MOCK_H
+
+#include "w25q.h"
+
+#define W25Q_MOCK_POWER_CUT_EXIT 42 // exit code of a process whose power was cut
+
+void w25q_mock_init(void); // flash in shared memory, survives fork()ed "reboots"
+int w25q_mock_load(const char * image); // image of the whole flash or of its beginning
+void w25q_mock_setPowerCut(uint32_t afterOps); // the process exits at that erase/program, 0: never
+uint32_t w25q_mock_getOpCount(void); // erases and programs
+uint32_t w25q_mock_getEraseCount(uint32_t index);
+void w25q_mock_resetEraseCounts(void);
+
+#endif /* W25Q_MOCK_H */
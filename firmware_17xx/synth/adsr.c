@@ -1,5 +1,5 @@
 ////////////////////////////////////////////////////////////////////////////////
-// ADSR envelope, based on electricdruid's ENVGEN7_MOOG.ASM
+// DAHDSR envelope, based on electricdruid's ENVGEN7_MOOG.ASM
 ////////////////////////////////////////////////////////////////////////////////
 
 /*
@@ -49,15 +49,68 @@ static uint32_t getPhaseInc(uint8_t v)
 	return r;
 }
 
+static inline uint16_t computeOutput(uint32_t phase, const uint16_t lookup[], int8_t isExp)
+{
+	if(isExp)
+		return computeShape(phase,lookup,2);
+	else
+		return phase>>8; // 20bit -> 16 bit
+}
+
+static inline uint16_t computeStageOutput(struct adsr_s * a)
+{
+	uint16_t o=0;
+	
+	int8_t isExp=(a->expStages>>a->stage)&1;
+	
+	switch(a->stage)
+	{
+	case sAttack:
+		o=computeOutput(a->phase,attackCurveLookup,isExp);
+		break;
+	case sDecay:
+	case sRelease:
+		o=UINT16_MAX-computeOutput(a->phase,decayCurveLookup,isExp);
+		break;
+	case sSustain:
+		o=a->sustainCV;
+		break;
+	default:
+		;
+	}
+	
+	return scaleU16U16(o,a->stageMul)+a->stageAdd;
+}
+
+static inline void updateActivity(struct adsr_s * a)
+{
+	// stages that don't move can be skipped by updates, their output is computed once here
+	
+	a->active=a->stageIncrement!=0;
+	
+	if(!a->active)
+		a->output=computeStageOutput(a);
+}
+
 static inline void updateStageVars(struct adsr_s * a, adsrStage_t s)
 {
 	switch(s)
 	{
+	case sDelay:
+		a->stageAdd=scaleU16U16(a->stageLevel,a->levelCV); // hold previous level
+		a->stageMul=0;
+		a->stageIncrement=a->delayIncrement;
+		break;
 	case sAttack:
 		a->stageAdd=scaleU16U16(a->stageLevel,a->levelCV);
 		a->stageMul=scaleU16U16(UINT16_MAX-a->stageLevel,a->levelCV);
 		a->stageIncrement=a->attackIncrement;
 		break;
+	case sHold:
+		a->stageAdd=a->levelCV;
+		a->stageMul=0;
+		a->stageIncrement=a->holdIncrement;
+		break;
 	case sDecay:
 		a->stageAdd=scaleU16U16(a->sustainCV,a->levelCV);
 		a->stageMul=scaleU16U16(UINT16_MAX-a->sustainCV,a->levelCV);
@@ -78,34 +131,31 @@ static inline void updateStageVars(struct adsr_s * a, adsrStage_t s)
 		a->stageMul=0;
 		a->stageIncrement=0;
 	}
+	
+	updateActivity(a);
 }
 
 static LOWERCODESIZE void updateIncrements(struct adsr_s * adsr)
 {
-	uint32_t aInc, dInc, rInc;
+	uint32_t aInc, dInc, rInc, dlInc, hInc;
 	
 	aInc=getPhaseInc(adsr->attackCV>>8)>>adsr->speedShift;
 	dInc=getPhaseInc(adsr->decayCV>>8)>>adsr->speedShift;
 	rInc=getPhaseInc(adsr->releaseCV>>8)>>adsr->speedShift;
+	dlInc=getPhaseInc(adsr->delayCV>>8)>>adsr->speedShift;
+	hInc=getPhaseInc(adsr->holdCV>>8)>>adsr->speedShift;
 	
 	adsr->attackIncrement=aInc<<4; // phase is 20 bits, from bit 4 to bit 23
 	adsr->decayIncrement=dInc<<4;
 	adsr->releaseIncrement=rInc<<4;
+	adsr->delayIncrement=dlInc<<4;
+	adsr->holdIncrement=hInc<<4;
 	
 	// immediate update of env settings
 	
 	updateStageVars(adsr,adsr->stage);
 }
 
-
-static inline uint16_t computeOutput(uint32_t phase, const uint16_t lookup[], int8_t isExp)
-{
-	if(isExp)
-		return computeShape(phase,lookup,2);
-	else
-		return phase>>8; // 20bit -> 16 bit
-}
-
 static NOINLINE void handlePhaseOverflow(struct adsr_s * a)
 {
 	a->phase=0;
@@ -115,6 +165,18 @@ static NOINLINE void handlePhaseOverflow(struct adsr_s * a)
 
 	switch(a->stage)
 	{
+	case sAttack:
+		updateStageVars(a,sAttack);
+		return;
+	case sHold:
+		a->output=a->levelCV;
+		if(a->holdCV)
+		{
+			updateStageVars(a,sHold);
+			return;
+		}
+		a->stage=sDecay;
+		/* fall through */
 	case sDecay:
 		a->output=a->levelCV;
 		updateStageVars(a,sDecay);
@@ -133,7 +195,7 @@ static NOINLINE void handlePhaseOverflow(struct adsr_s * a)
 		return;			
 	case sDone:
 		a->stage=sWait;
-		a->output=0;
+		updateStageVars(a,sWait);
 		return;
 	default:
 		;
@@ -178,15 +240,25 @@ void adsr_setCVs(struct adsr_s * adsr, uint16_t atk, uint16_t dec, uint16_t sus,
 		updateIncrements(adsr);
 }
 
+void adsr_setDelayHoldCVs(struct adsr_s * adsr, uint16_t dly, uint16_t hld)
+{
+	if(adsr->delayCV!=dly || adsr->holdCV!=hld)
+	{
+		adsr->delayCV=dly;
+		adsr->holdCV=hld;
+		updateIncrements(adsr);
+	}
+}
+
 void adsr_setGate(struct adsr_s * a, int8_t gate)
 {
 	a->phase=0;
-	a->stageLevel=((uint32_t)a->output<<16)/a->levelCV;
+	a->stageLevel=(a->levelCV)?((uint32_t)a->output<<16)/a->levelCV:0; // levelCV is 0 until the first note, the M3 would return 0, hosts trap
 
 	if(gate)
 	{
-		a->stage=sAttack;
-		updateStageVars(a,sAttack);
+		a->stage=(a->delayCV)?sDelay:sAttack;
+		updateStageVars(a,a->stage);
 	}
 	else
 	{
@@ -207,9 +279,9 @@ void adsr_reset(struct adsr_s * adsr)
 	updateStageVars(adsr,sWait);
 }
 
-inline void adsr_setShape(struct adsr_s * adsr, int8_t isExp, int8_t isLoop)
+inline void adsr_setShape(struct adsr_s * adsr, uint8_t expStages, int8_t isLoop)
 {
-	adsr->expOutput=isExp;
+	adsr->expStages=expStages;
 	adsr->loop=isLoop;
 	
 	if (adsr->loop && adsr->stage==sSustain)
@@ -218,6 +290,8 @@ inline void adsr_setShape(struct adsr_s * adsr, int8_t isExp, int8_t isLoop)
 		adsr->stage=sDecay;
 		handlePhaseOverflow(adsr);
 	}
+	
+	updateActivity(adsr);
 }
 
 void adsr_setSpeedShift(struct adsr_s * adsr, int8_t shift)
@@ -251,28 +325,19 @@ inline void adsr_update(struct adsr_s * a)
 	
 	// compute output level
 	
-	uint16_t o=0;
-	
-	switch(a->stage)
-	{
-	case sAttack:
-		o=computeOutput(a->phase,attackCurveLookup,a->expOutput);
-		break;
-	case sDecay:
-	case sRelease:
-		o=UINT16_MAX-computeOutput(a->phase,decayCurveLookup,a->expOutput);
-		break;
-	case sSustain:
-		o=a->sustainCV;
-		break;
-	default:
-		;
-	}
-	
-	a->output=scaleU16U16(o,a->stageMul)+a->stageAdd;
+	a->output=computeStageOutput(a);
 
 	// phase increment
 	
 	a->phase+=a->stageIncrement;
 }
 
+void adsr_updateBank(struct adsr_s adsrs[], int8_t count)
+{
+	int8_t i;
+	
+	for(i=0;i<count;++i)
+		if(adsrs[i].active)
+			adsr_update(&adsrs[i]);
+}
+
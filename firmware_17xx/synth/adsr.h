@@ -5,30 +5,41 @@
 
 typedef enum
 {
-	sWait=0,sAttack=1,sDecay=2,sSustain=3,sRelease=4,sDone=5
+	sWait=0,sDelay=1,sAttack=2,sHold=3,sDecay=4,sSustain=5,sRelease=6,sDone=7
 } adsrStage_t;
 
+// exponential curve flags, for adsr_setShape()
+#define ADSR_EXP_ATTACK (1<<sAttack)
+#define ADSR_EXP_DECAY (1<<sDecay)
+#define ADSR_EXP_RELEASE (1<<sRelease)
+#define ADSR_EXP_ALL (ADSR_EXP_ATTACK|ADSR_EXP_DECAY|ADSR_EXP_RELEASE)
+
 struct adsr_s
 {
 	uint32_t stageIncrement;	
 	uint32_t phase;
 	uint32_t attackIncrement,decayIncrement,releaseIncrement; 
+	uint32_t delayIncrement,holdIncrement; 
 	
 	uint16_t sustainCV,levelCV;
 	uint16_t attackCV,decayCV,releaseCV;
+	uint16_t delayCV,holdCV; // 0: stage is skipped
 	uint16_t stageLevel,stageAdd,stageMul;
 	uint16_t output;
 
-	int8_t expOutput,gate,loop;
+	uint8_t expStages; // ADSR_EXP_* flags
+	int8_t gate,loop;
 	int8_t speedShift;
+	int8_t active; // 0 when output doesn't move (sWait, sSustain), output is then cached
 	
 	adsrStage_t stage;
 };
 
 void adsr_setCVs(struct adsr_s * adsr, uint16_t atk, uint16_t dec, uint16_t sus, uint16_t rls, uint16_t lvl, uint8_t mask);
+void adsr_setDelayHoldCVs(struct adsr_s * adsr, uint16_t dly, uint16_t hld);
 void adsr_setGate(struct adsr_s * adsr, int8_t gate);
 
-void adsr_setShape(struct adsr_s * adsr, int8_t isExp, int8_t isLoop);
+void adsr_setShape(struct adsr_s * adsr, uint8_t expStages, int8_t isLoop);
 void adsr_setSpeedShift(struct adsr_s * adsr, int8_t shift);
 
 adsrStage_t adsr_getStage(struct adsr_s * adsr);
@@ -38,6 +49,7 @@ void adsr_reset(struct adsr_s * adsr);
 
 void adsr_init(struct adsr_s * adsr);
 void adsr_update(struct adsr_s * adsr);
+void adsr_updateBank(struct adsr_s adsrs[], int8_t count); // only updates active envelopes
 
 #endif	/* ADSR_H */
 
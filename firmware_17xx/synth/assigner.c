@@ -23,12 +23,12 @@ static struct
 	struct allocation_s allocation[SYNTH_VOICE_COUNT];
 	uint8_t patternOffsets[SYNTH_VOICE_COUNT];
 	assignerPriority_t priority;
-	uint8_t voiceMask;
+	uint16_t voiceMask;
 	int8_t mono;
 	int8_t hold;
 } assigner;
 
-static const uint8_t polyPattern[SYNTH_VOICE_COUNT]={0,ASSIGNER_NO_NOTE,ASSIGNER_NO_NOTE,ASSIGNER_NO_NOTE,ASSIGNER_NO_NOTE,ASSIGNER_NO_NOTE};	
+static const uint8_t polyPattern[SYNTH_VOICE_COUNT]={0,[1 ... SYNTH_VOICE_COUNT-1]=ASSIGNER_NO_NOTE};	
 
 static inline void setNoteState(uint8_t note, int8_t gate, uint16_t velocity, uint32_t timestamp)
 {
@@ -247,7 +247,7 @@ void assigner_setPriority(assignerPriority_t prio)
 	assigner.priority=prio;
 }
 
-void assigner_setVoiceMask(uint8_t mask)
+void assigner_setVoiceMask(uint16_t mask)
 {
 	if(mask==assigner.voiceMask)
 		return;
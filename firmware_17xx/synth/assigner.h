@@ -14,7 +14,7 @@ typedef enum
 } assignerPriority_t;
 
 void assigner_setPriority(assignerPriority_t prio);
-void assigner_setVoiceMask(uint8_t mask);
+void assigner_setVoiceMask(uint16_t mask);
 
 int8_t assigner_getAssignment(int8_t voice, uint8_t * note);
 int8_t assigner_getAnyPressed(void);
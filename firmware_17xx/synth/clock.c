@@ -12,6 +12,7 @@
 struct
 {
 	int32_t counter,speed;
+	uint32_t steps,stepReciprocal; // for clock_getPosition()
 	uint32_t pendingExtClock;
 	int8_t pendingReset;
 } clock;
@@ -24,6 +25,8 @@ void clock_updateSpeed(void)
 		clock.speed=((60UL*TICKER_HZ)<<FRAC_SHIFT)/settings.seqArpClock;
 	else
 		clock.speed=extClockDividers[((uint32_t)settings.seqArpClock*(sizeof(extClockDividers)/sizeof(uint16_t)-1))/(CLOCK_MAX_BPM-1)]<<FRAC_SHIFT;
+	
+	clock.stepReciprocal=MIN(UINT32_MAX,(1ULL<<(32+FRAC_SHIFT))/clock.speed);
 }
 
 inline uint16_t clock_getSpeed(void)
@@ -39,6 +42,11 @@ inline uint16_t clock_getCounter(void)
 	return clock.counter>>FRAC_SHIFT;
 }
 
+inline uint32_t clock_getPosition(void)
+{
+	return (clock.steps<<16)+(((uint64_t)clock.counter*clock.stepReciprocal)>>32);
+}
+
 inline void clock_reset(void)
 {
 	clock.pendingExtClock=0;
@@ -63,6 +71,7 @@ void clock_update(void)
 		if(clock.pendingReset)
 		{
 			clock.counter=0;
+			clock.steps=0;
 			clock.pendingReset=0;
 			synth_clockEvent();
 		}
@@ -79,6 +88,7 @@ void clock_update(void)
 		if(clock.counter>=clock.speed)
 		{
 			clock.counter-=clock.speed;
+			++clock.steps;
 			synth_clockEvent();
 		}
 	}
@@ -16,6 +16,7 @@ typedef enum
 void clock_updateSpeed(void);
 uint16_t clock_getSpeed(void); // returns 0 if clock is stalled
 uint16_t clock_getCounter(void);
+uint32_t clock_getPosition(void); // in steps since last reset, 16.16 fixed point
 void clock_reset(void);
 void clock_extClockTick(void);
 
@@ -21,6 +21,9 @@
 #define DACSPI_CMD_SET_A 0x7000
 #define DACSPI_CMD_SET_B 0xf000
 
+#define DWT_CTRL (*(volatile uint32_t *)0xe0001000)
+#define DWT_CYCCNT (*(volatile uint32_t *)0xe0001004)
+
 #define DACSPI_DMACONFIG \
 		GPDMA_DMACCxConfig_E | \
 		GPDMA_DMACCxConfig_SrcPeripheral(DMA_CHANNEL_UART2_TX__T3_MAT_0) | \
@@ -44,28 +47,22 @@ static const uint32_t spiMuxCommandsConst[DACSPI_CHANNEL_COUNT][3] =
 };
 
 
-static const uint16_t oscChannelCommand[SYNTH_VOICE_COUNT*2] = 
-{
-	DACSPI_CMD_SET_A,DACSPI_CMD_SET_B,
-	DACSPI_CMD_SET_A,DACSPI_CMD_SET_B,
-	DACSPI_CMD_SET_A,DACSPI_CMD_SET_B,
-	DACSPI_CMD_SET_A,DACSPI_CMD_SET_B,
-	DACSPI_CMD_SET_A,DACSPI_CMD_SET_B,
-	DACSPI_CMD_SET_A,DACSPI_CMD_SET_B,
-};
-
 static struct
 {
-	uint16_t oscCommands[DACSPI_BUFFER_COUNT][SYNTH_VOICE_COUNT*2];
+	// voices beyond DACSPI_BOARD_VOICE_COUNT are computed but not sent by the DMA (expander boards), so they have no commands
+	uint16_t oscCommands[DACSPI_BUFFER_COUNT][DACSPI_BOARD_VOICE_COUNT*2];
 	uint32_t cvCommands[DACSPI_BUFFER_COUNT];
 	uint32_t spiMuxCommands[DACSPI_CHANNEL_COUNT][3];
 	uint16_t cr0Pre, cr0Post, sselPre, sselPost;
 	int curSet;
+	
+	uint32_t irqCycles, irqPeakCycles, lastLoadCycle;
 } dacspi EXT_RAM;
 
 __attribute__ ((used)) void DMA_IRQHandler(void)
 {
 	static uint8_t phase=0;
+	uint32_t startCycle=DWT_CYCCNT;
 	
 	LPC_GPDMA->IntTCClear=LPC_GPDMA->IntTCStat; // acknowledge interrupt
 
@@ -88,6 +85,12 @@ __attribute__ ((used)) void DMA_IRQHandler(void)
 	++phase;
 	if(phase>=4)
 		phase=0;
+	
+	// CPU load measurement
+	
+	startCycle=DWT_CYCCNT-startCycle;
+	dacspi.irqCycles+=startCycle;
+	dacspi.irqPeakCycles=MAX(dacspi.irqPeakCycles,startCycle);
 }
 
 static void buildLLIs(int buffer, int channel)
@@ -180,7 +183,12 @@ static void buildLLIs(int buffer, int channel)
 
 FORCEINLINE void dacspi_setOscValue(int32_t buffer, int channel, uint16_t value)
 {
-	dacspi.oscCommands[buffer][channel]=(value>>4)|oscChannelCommand[channel];
+#if SYNTH_VOICE_COUNT>DACSPI_BOARD_VOICE_COUNT
+	if(channel>=DACSPI_BOARD_VOICE_COUNT*2)
+		return;
+#endif
+
+	dacspi.oscCommands[buffer][channel]=(value>>4)|((channel&1)?DACSPI_CMD_SET_B:DACSPI_CMD_SET_A);
 }
 
 FORCEINLINE void dacspi_setCVValue(int channel, uint16_t value, int8_t noDblBuf)
@@ -198,6 +206,29 @@ FORCEINLINE void dacspi_setCVValue(int channel, uint16_t value, int8_t noDblBuf)
 	}
 }
 
+uint16_t dacspi_getIRQLoad(uint32_t * peakCycles)
+{
+	uint32_t now,cycles,peak,elapsed;
+	
+	BLOCK_INT(1)
+	{
+		now=DWT_CYCCNT;
+		cycles=dacspi.irqCycles;
+		peak=dacspi.irqPeakCycles;
+		
+		dacspi.irqCycles=0;
+		dacspi.irqPeakCycles=0;
+	}
+
+	elapsed=now-dacspi.lastLoadCycle;
+	dacspi.lastLoadCycle=now;
+	
+	if(peakCycles)
+		*peakCycles=peak;
+	
+	return ((uint64_t)cycles*1000)/MAX(1,elapsed);
+}
+
 void dacspi_init(void)
 {
 	int i,j;
@@ -210,6 +241,12 @@ void dacspi_init(void)
 
 	memset(&dacspi,0,sizeof(dacspi));
 	memcpy(dacspi.spiMuxCommands,spiMuxCommandsConst,sizeof(spiMuxCommandsConst));
+	
+	// cycle counter, for CPU load measurement
+	
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT_CYCCNT=0;
+	DWT_CTRL|=1;
 
 	// init SPI mux
 
@@ -3,9 +3,10 @@
 
 #include "synth.h"
 
+#define DACSPI_BOARD_VOICE_COUNT 6 // voices DACs wired to the SPI mux
 #define DACSPI_BUFFER_COUNT 64
 #define DACSPI_CV_COUNT 16
-#define DACSPI_CHANNEL_COUNT 7
+#define DACSPI_CHANNEL_COUNT (DACSPI_BOARD_VOICE_COUNT+1) // voices + CVs
 #define DACSPI_OSC_CHANNEL_WAIT_STATES 9
 #define DACSPI_CV_CHANNEL_WAIT_STATES 3
 #define DACSPI_TIMER_MATCH 24
@@ -15,8 +16,14 @@
 
 #define DACSPI_UPDATE_HZ (SYNTH_MASTER_CLOCK/(DACSPI_CV_COUNT*DACSPI_TICK_RATE))
 
+// the per-voice state is in main RAM, 16 voices leave just the stack reservation (see synth.ld)
+#if SYNTH_VOICE_COUNT<DACSPI_BOARD_VOICE_COUNT || SYNTH_VOICE_COUNT>16
+#error "SYNTH_VOICE_COUNT must be in the 6..16 range, more doesn't fit in RAM"
+#endif
+
 void dacspi_init(void);
 void dacspi_setOscValue(int32_t buffer, int channel, uint16_t value); // 16bit value
 void dacspi_setCVValue(int channel, uint16_t value, int8_t noDblBuf); // 16bit value
+uint16_t dacspi_getIRQLoad(uint32_t * peakCycles); // DMA IRQ CPU load in 1/1000th since last call
 
 #endif
@@ -7,16 +7,32 @@
 #include "scan.h"
 #include "dacspi.h"
 
+#define LFO_SPEED_MUL ((1ULL<<(24+16))/(DACSPI_UPDATE_HZ*30)) // (1<<24)/(DACSPI_UPDATE_HZ*30) in 16.16 fixed point
+#define LFO_SYNC_TICK_RATIO ((TICKER_HZ<<16)/DACSPI_UPDATE_HZ) // CV updates per tick, reciprocal in 16.16 fixed point
+#define LFO_SYNC_RATE_SHIFT 3 // rate smoothing (for MIDI clock)
+#define LFO_SYNC_ERROR_SHIFT 2 // phase error correction speed
+
+static FORCEINLINE uint32_t xorshift(uint32_t x)
+{
+	x^=x<<13;
+	x^=x>>17;
+	x^=x<<5;
+	return x;
+}
+
 static inline void updateIncrement(struct lfo_s * lfo)
 {
-	lfo->increment=lfo->speed*(1-(lfo->halfPeriodCounter&1)*2);
+	if(lfo->synced)
+		lfo->increment=0; // phase is handled by updateSyncedPhase()
+	else
+		lfo->increment=lfo->speed*(1-(lfo->halfPeriodCounter&1)*2);
 }
 
 static inline void updateSpeed(struct lfo_s * lfo)
 {
 	int32_t spd;
 	
-	spd=((1LL<<24)*scan_potFrom16bits(lfo->bpmCV))/(DACSPI_UPDATE_HZ*30);
+	spd=((uint64_t)scan_potFrom16bits(lfo->bpmCV)*LFO_SPEED_MUL)>>16;
 	spd<<=lfo->speedShift;
 
 	lfo->speed=spd;
@@ -30,6 +46,24 @@ static inline void handlePhaseOverflow(struct lfo_s * l)
 	updateIncrement(l);
 }
 
+static inline void updateSyncedPhase(struct lfo_s * l)
+{
+	uint32_t c,half;
+	
+	c=l->syncCycle+=l->syncIncrement;
+	half=(c>>24)&1;
+
+	// odd half periods have decreasing phase
+	l->phase=(half)?0x00ffffff-(c&0x00ffffff):(c&0x00ffffff);
+	
+	if(half!=(l->halfPeriodCounter&1))
+	{
+		++l->halfPeriodCounter;
+		if(!half)
+			l->phase=0; // new period
+	}
+}
+
 void lfo_setCVs(struct lfo_s * lfo, uint16_t bpm, uint16_t lvl)
 {
 	lfo->levelCV=lvl;
@@ -58,6 +92,45 @@ void lfo_setSpeedShift(struct lfo_s * lfo, int8_t shift)
 	}
 }
 
+void lfo_setSync(struct lfo_s * lfo, int8_t synced, int8_t periodShift)
+{
+	if(synced!=lfo->synced || periodShift!=lfo->syncShift)
+	{
+		lfo->synced=synced;
+		lfo->syncShift=periodShift;
+		lfo->syncPrevClockPos=UINT32_MAX; // realign on next lfo_syncToClock()
+		lfo->syncRate=0;
+		updateIncrement(lfo);
+	}
+}
+
+void lfo_syncToClock(struct lfo_s * lfo, uint32_t clockPos)
+{
+	uint32_t target;
+	int32_t err;
+
+	if(!lfo->synced)
+		return;
+	
+	// clock position (16.16 steps) -> position in cycle (1<<25 per cycle)
+	target=clockPos<<(9-lfo->syncShift);
+	
+	if(clockPos<lfo->syncPrevClockPos)
+	{
+		// clock was reset (or just synced) -> realign, keep rate
+		lfo->syncCycle=target;
+	}
+	else
+	{
+		// follow clock rate (smoothed for bursty MIDI clocks) and correct phase error
+		lfo->syncRate+=((int32_t)(target-(lfo->syncPrevClockPos<<(9-lfo->syncShift)))-lfo->syncRate)>>LFO_SYNC_RATE_SHIFT;
+	}
+
+	err=target-lfo->syncCycle;
+	lfo->syncIncrement=((int64_t)(lfo->syncRate+(err>>LFO_SYNC_ERROR_SHIFT))*LFO_SYNC_TICK_RATIO)>>16;
+	lfo->syncPrevClockPos=clockPos;
+}
+
 int16_t inline lfo_getOutput(struct lfo_s * lfo)
 {
 	return lfo->output;
@@ -88,6 +161,13 @@ const char * lfo_shapeName(lfoShape_t shape)
 
 void lfo_reset(struct lfo_s * lfo)
 {
+	if(lfo->synced)
+	{
+		// keep clock phase, only restart half periods count
+		lfo->halfPeriodCounter=(lfo->syncCycle>>24)&1;
+		return;
+	}
+	
 	lfo->halfPeriodCounter=0;
 	lfo->phase=0;
 	
@@ -96,22 +176,34 @@ void lfo_reset(struct lfo_s * lfo)
 
 void lfo_init(struct lfo_s * lfo)
 {
+	static uint32_t seed=0;
+	
 	memset(lfo,0,sizeof(struct lfo_s));
-	lfo->noise=random();
+	
+	// distinct, non zero seed for each LFO
+	seed+=0x9e3779b9;
+	lfo->noise=xorshift(seed);
 }
 
-inline void lfo_update(struct lfo_s * l)
+static FORCEINLINE void update(struct lfo_s * l, lfoShape_t shape)
 {
 	int16_t rawOutput;
 	
-	// if bit 24 or higher is set, it's an overflow -> a half period is done!
-	
-	if(l->phase>>24) 
-		handlePhaseOverflow(l);
+	if(l->synced)
+	{
+		updateSyncedPhase(l);
+	}
+	else
+	{
+		// if bit 24 or higher is set, it's an overflow -> a half period is done!
+
+		if(l->phase>>24) 
+			handlePhaseOverflow(l);
+	}
 	
 	// handle shapes
 
-	switch(l->shape)
+	switch(shape)
 	{
 	case lsPulse:
 		rawOutput=INT16_MAX;
@@ -121,7 +213,7 @@ inline void lfo_update(struct lfo_s * l)
 		break;
 	case lsRand:
 		if(!l->phase)
-			l->noise=random();
+			l->noise=xorshift(l->noise);
 		rawOutput=(l->noise&UINT16_MAX)+INT16_MIN;
 		break;
 	case lsSine:
@@ -146,7 +238,7 @@ inline void lfo_update(struct lfo_s * l)
 	
 	// compute output
 	
-	if(!l->bpmCV)
+	if(!l->bpmCV && !l->synced)
 	{
 		// constant output when BPM is zero
 		
@@ -170,4 +262,31 @@ inline void lfo_update(struct lfo_s * l)
 	}
 }
 
+inline void lfo_update(struct lfo_s * l)
+{
+	update(l,l->shape);
+}
+
+void lfo_updateBank(struct lfo_s lfos[], int8_t count)
+{
+	int8_t i;
+
+	// shape is shared by the whole bank, it's only handled once
+	
+#define UPDATE_BANK(shape) case shape: for(i=0;i<count;++i) update(&lfos[i],shape); break;
+
+	switch(lfos[0].shape)
+	{
+		UPDATE_BANK(lsPulse)
+		UPDATE_BANK(lsTri)
+		UPDATE_BANK(lsRand)
+		UPDATE_BANK(lsSine)
+		UPDATE_BANK(lsNoise)
+		UPDATE_BANK(lsSaw)
+		UPDATE_BANK(lsRevSaw)
+	}
+	
+#undef UPDATE_BANK
+}
+
 
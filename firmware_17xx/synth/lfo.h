@@ -3,6 +3,8 @@
 
 #include "synth.h"
 
+#define LFO_SYNC_MAX_SHIFT 3 // longest synced period is 2^LFO_SYNC_MAX_SHIFT clock steps
+
 typedef enum
 {
 	lsPulse=0,lsTri=1,lsRand=2,lsSine=3,lsNoise=4,lsSaw=5,lsRevSaw=6
@@ -22,6 +24,12 @@ struct lfo_s
 	
 	int8_t speedShift;
 	
+	// clock sync
+	int8_t synced,syncShift; // period is 2^syncShift clock steps
+	uint32_t syncCycle; // position in cycle, one cycle is 1<<25
+	uint32_t syncPrevClockPos;
+	int32_t syncRate,syncIncrement;
+	
 	lfoShape_t shape;
 	uint8_t halfPeriodLimit;
 };
@@ -29,6 +37,8 @@ struct lfo_s
 void lfo_setCVs(struct lfo_s * lfo, uint16_t spd, uint16_t lvl);
 void lfo_setShape(struct lfo_s * lfo, lfoShape_t shape, uint8_t halfPeriods); // set halfPeriods to 0 for unlimited periods
 void lfo_setSpeedShift(struct lfo_s * lfo, int8_t shift);
+void lfo_setSync(struct lfo_s * lfo, int8_t synced, int8_t periodShift); // period is 2^periodShift clock steps
+void lfo_syncToClock(struct lfo_s * lfo, uint32_t clockPos); // @ TICKER_HZ, clockPos from clock_getPosition()
 
 int16_t lfo_getOutput(struct lfo_s * lfo);
 const char * lfo_shapeName(lfoShape_t shape);
@@ -37,6 +47,7 @@ void lfo_reset(struct lfo_s * lfo);
 
 void lfo_init(struct lfo_s * lfo);
 void lfo_update(struct lfo_s * lfo);
+void lfo_updateBank(struct lfo_s lfos[], int8_t count); // lfos must all have the same shape
 
 #endif	/* LFO_H */
 
@@ -210,10 +210,10 @@ static midiPort_t getPort(MidiDevice * device)
 
 static int8_t setContinuousParameterCoarse(continuousParameter_t param, uint8_t value)
 {
-	if((currentPreset.continuousParameters[param]>>9)!=value)
+	if((currentPreset->continuousParameters[param]>>9)!=value)
 	{
-		currentPreset.continuousParameters[param]&=0x01fc;
-		currentPreset.continuousParameters[param]|=(uint16_t)value<<9;
+		currentPreset->continuousParameters[param]&=0x01fc;
+		currentPreset->continuousParameters[param]|=(uint16_t)value<<9;
 		return 1;	
 	}
 	return 0;	
@@ -221,10 +221,10 @@ static int8_t setContinuousParameterCoarse(continuousParameter_t param, uint8_t
 
 static int8_t setContinuousParameterFine(continuousParameter_t param, uint8_t value)
 {
-	if(((currentPreset.continuousParameters[param]>>2)&0x7f)!=value)
+	if(((currentPreset->continuousParameters[param]>>2)&0x7f)!=value)
 	{
-		currentPreset.continuousParameters[param]&=0xfe00;
-		currentPreset.continuousParameters[param]|=(uint16_t)value<<2;
+		currentPreset->continuousParameters[param]&=0xfe00;
+		currentPreset->continuousParameters[param]|=(uint16_t)value<<2;
 		return 1;	
 	}
 	return 0;	
@@ -238,9 +238,9 @@ static int8_t setSteppedParameter(steppedParameter_t param, uint8_t value, int8_
 	if(!isRaw)
 		v=(v*steppedParametersSteps[param].param)>>7;
 
-	if(currentPreset.steppedParameters[param]!=v)
+	if(currentPreset->steppedParameters[param]!=v)
 	{
-		currentPreset.steppedParameters[param]=v;
+		currentPreset->steppedParameters[param]=v;
 		changed=1;	
 	}
 	
@@ -252,14 +252,14 @@ static int8_t setSteppedParameter(steppedParameter_t param, uint8_t value, int8_
 			case spBBank_Unsaved:
 			case spAXOvrBank_Unsaved:
 			case spBXOvrBank_Unsaved:
-				synth_getBankName(value,currentPreset.oscBank[sp2abx[param]]);
+				synth_getBankName(value,currentPreset->oscBank[sp2abx[param]]);
 				midi.pendingBankWaveTimeout[sp2abx[param]]=currentTick+PENDING_UPDATE_TIMEOUT;
 				break;
 			case spAWave_Unsaved:
 			case spBWave_Unsaved:
 			case spAXOvrWave_Unsaved:
 			case spBXOvrWave_Unsaved:
-				synth_getWaveName(value,currentPreset.oscWave[sp2abx[param]]);
+				synth_getWaveName(value,currentPreset->oscWave[sp2abx[param]]);
 				midi.pendingBankWaveTimeout[sp2abx[param]]=currentTick+PENDING_UPDATE_TIMEOUT;
 				break;
 			case spUnison:
@@ -399,11 +399,11 @@ static void ccEvent(MidiDevice * device, uint8_t channel, uint8_t control, uint8
 			if(midi.isNrpnStepped[port])
 			{
 				steppedParameter_t s=midi.currentNrpn[port];
-				change=setSteppedParameter(s,MIN(steppedParametersSteps[s].param-1,currentPreset.steppedParameters[s]+1),1);
+				change=setSteppedParameter(s,MIN(steppedParametersSteps[s].param-1,currentPreset->steppedParameters[s]+1),1);
 			}
 			else
 			{
-				uint8_t v=currentPreset.continuousParameters[midi.currentNrpn[port]]>>9;
+				uint8_t v=currentPreset->continuousParameters[midi.currentNrpn[port]]>>9;
 				change=setContinuousParameterCoarse(midi.currentNrpn[port],MIN(INT8_MAX,v+1));
 			}
 			break;
@@ -411,11 +411,11 @@ static void ccEvent(MidiDevice * device, uint8_t channel, uint8_t control, uint8
 			if(midi.isNrpnStepped[port])
 			{
 				steppedParameter_t s=midi.currentNrpn[port];
-				change=setSteppedParameter(s,MAX(0,currentPreset.steppedParameters[s]-1),1);
+				change=setSteppedParameter(s,MAX(0,currentPreset->steppedParameters[s]-1),1);
 			}
 			else
 			{
-				uint8_t v=currentPreset.continuousParameters[midi.currentNrpn[port]]>>9;
+				uint8_t v=currentPreset->continuousParameters[midi.currentNrpn[port]]>>9;
 				change=setContinuousParameterCoarse(midi.currentNrpn[port],MAX(0,v-1));
 			}
 			break;
@@ -547,7 +547,7 @@ void midi_update(void)
 		{
 			synth_silenceSynth();
 			
-			settings_save();		
+			settings_requestSave();
 
 			preset_loadCurrent(settings.presetNumber);
 			ui_setPresetModified(0);	
@@ -293,10 +293,18 @@ void scan_setMode(int8_t isSmpMasterMixMode)
 	TIM_Cmd(LPC_TIM2,ENABLE);
 }
 
-void scan_sampleMasterMix(uint16_t sampleCount, uint16_t * buffer)
+static inline uint16_t sampleMasterMix(void)
 {
-	uint16_t mini=UINT16_MAX,maxi=0,extents;
-	uint16_t *buf;
+	return readADC(MIXSCAN_ADC_CHANNEL)+ // because 4x upsampling
+		   readADC(MIXSCAN_ADC_CHANNEL)+
+		   readADC(MIXSCAN_ADC_CHANNEL)+
+		   readADC(MIXSCAN_ADC_CHANNEL);
+}
+
+uint32_t scan_countMasterMixCrossings(uint16_t extentsSampleCount, uint16_t sampleCount)
+{
+	uint16_t mini=UINT16_MAX,maxi=0,middle,sample,prev;
+	uint32_t count=0;
 	
 	// ensure no spurious reads from other channels
 	
@@ -304,35 +312,35 @@ void scan_sampleMasterMix(uint16_t sampleCount, uint16_t * buffer)
 	readADC(MIXSCAN_ADC_CHANNEL);
 	
 	// sample master mix at dacspi tickrate
-
-	buf=buffer;
-	for(uint16_t sc=0;sc<sampleCount;++sc)
+	
+	// first pass: waveform extents, its middle is the crossing threshold
+	
+	for(uint16_t sc=0;sc<extentsSampleCount;++sc)
 	{
-		uint16_t sample=readADC(MIXSCAN_ADC_CHANNEL)+ // because 4x upsampling
-						readADC(MIXSCAN_ADC_CHANNEL)+
-						readADC(MIXSCAN_ADC_CHANNEL)+
-						readADC(MIXSCAN_ADC_CHANNEL);
+		sample=sampleMasterMix();
 		
 		mini=MIN(mini,sample);
 		maxi=MAX(maxi,sample);
-		
-		*buf++=sample;
 	}
 	
-//	rprintf(0,"scan_sampleMasterMix min %d max %d\n",mini,maxi);
+	middle=((uint32_t)mini+maxi)>>1;
 	
-	// extend waveform to 0..UINT16_MAX
+//	rprintf(0,"scan_countMasterMixCrossings min %d max %d\n",mini,maxi);
+
+	// second pass: count crossings on the fly, no sample buffer needed
 	
-	extents=MAX(1,maxi-mini);
-	buf=buffer;
-	for(uint16_t sc=0;sc<sampleCount;++sc)
+	prev=sampleMasterMix();
+	for(uint16_t sc=1;sc<sampleCount;++sc)
 	{
-		uint16_t sample=*buf;
+		sample=sampleMasterMix();
 		
-		sample=((sample-mini)*UINT16_MAX)/extents;
+		if ((prev<=middle&&sample>middle) || (prev>=middle&&sample<middle))
+			++count;
 		
-		*buf++=sample;
+		prev=sample;
 	}
+	
+	return count;
 }
 
 uint16_t scan_getPotValue(int8_t pot)
@@ -350,14 +358,18 @@ void scan_setScanEventCallback(scan_event_callback_t callback)
 	scan.eventCallback=callback;
 }
 
+// integer versions of roundf(x*a/b), divisors are constants so no actual division is done
+
 int scan_potTo16bits(int x)
 {
-	return ((int)roundf((((float)x)*UINT16_MAX)/SCAN_POT_MAX_VALUE));
+	x*=UINT16_MAX;
+	return (x+(x<0?-SCAN_POT_MAX_VALUE/2:SCAN_POT_MAX_VALUE/2))/SCAN_POT_MAX_VALUE;
 }
 
 int scan_potFrom16bits(int x)
 {
-	return ((int)roundf((((float)x)*SCAN_POT_MAX_VALUE)/UINT16_MAX));
+	x*=SCAN_POT_MAX_VALUE;
+	return (x+(x<0?-UINT16_MAX/2:UINT16_MAX/2))/UINT16_MAX;
 }
 
 void scan_init(void)
@@ -12,13 +12,40 @@
 #include "main.h"
 #include "midi.h"
 #include "ff.h"
+#include "w25q.h"
+#include "usb/msc_scsi.h"
 
 #include <ctype.h>
-#include <alloca.h>
 
 #define SAVE_INT " = %d\n"
 #define SAVE_STR " = %s\n"
 
+#define PRESET_BIN_MAGIC 0x4250434f // "OCPB"
+#define PRESET_BIN_VERSION 1
+
+#define PRESET_CACHE_SIZE 2 // the next two presets in the browsing direction
+
+struct presetBinHeader_s
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t headerSize;
+	
+	// schema
+	uint16_t cpCount,spCount;
+	uint8_t voiceCount,abxCount;
+	uint16_t nameSize,filenameSize;
+	uint32_t schemaHash; // parameters names and steps, see hashPresetSchema()
+	
+	uint32_t payloadHash;
+};
+
+// whole file, read at once in the idle USB block buffer
+#define PRESET_BIN_SIZE (sizeof(struct presetBinHeader_s)+sizeof(currentPreset->presetName)+ \
+	2*abxCount*MAX_FILENAME+cpCount*sizeof(uint16_t)+spCount+SYNTH_VOICE_COUNT)
+
+_Static_assert(PRESET_BIN_SIZE<=W25Q_SECTOR_SIZE,"binary presets must fit in the SCSI block buffer");
+
 const struct namedParam_s continuousParametersZeroCentered[cpCount] = 
 {
 	{"cpAFreq",0},
@@ -72,6 +99,12 @@ const struct namedParam_s continuousParametersZeroCentered[cpCount] =
 	{"cpWModBEnv",1},
 	{"cpWModVelocity",0},
 	{"cpAmpLevel",0},
+	{"cpFilDly",0},
+	{"cpFilHld",0},
+	{"cpAmpDly",0},
+	{"cpAmpHld",0},
+	{"cpWModDly",0},
+	{"cpWModHld",0},
 };
 
 const struct namedParam_s steppedParametersSteps[spCount] = 
@@ -118,18 +151,83 @@ const struct namedParam_s steppedParametersSteps[spCount] =
 	{NULL,128},
 	{"spLFOTrig",7},
 	{"spLFO2Trig",7},
+	{"spGlideMode",2},
+	{"spFilEnvCurves",8},
+	{"spAmpEnvCurves",8},
+	{"spWModEnvCurves",8},
+	{"spAmpEnvDigital",2},
+	{"spLFOPerVoice",2},
+	{"spLFO2PerVoice",2},
+	{"spLFOSync",8},
+	{"spLFO2Sync",8},
 };
 
 struct settings_s settings;
-struct preset_s currentPreset;
 
-struct loadLL_s
+// all sequencer banks in one file, the header holds the offset of each track,
+// slots are SEQ_NOTE_MEMORY aligned and never straddle a disk sector
+
+#define SEQUENCER_FILE SYNTH_SEQUENCES_PATH "/sequences.bin"
+#define SEQUENCER_FILE_MAGIC 0x42514553 // "SEQB"
+#define SEQUENCER_FILE_VERSION 1
+#define SEQUENCER_FILE_SLOT_COUNT (SEQ_BANK_COUNT*SEQ_TRACK_COUNT)
+
+struct sequencerFileHeader_s
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t slotSize;
+	uint16_t slotCount;
+	uint16_t offsets[SEQUENCER_FILE_SLOT_COUNT]; // 0 when the track was never saved, the header fits in slot 0
+};
+
+// settings are written to flash once they stop changing
+
+#define SETTINGS_SAVE_DELAY (TICKER_HZ*2)
+
+static struct
+{
+	uint32_t timeout; // UINT32_MAX when nothing is pending
+	uint32_t requests;
+	uint32_t writes;
+} settingsSave={.timeout=UINT32_MAX};
+
+// the current preset and the prefetched ones trade buffers, loading a prefetched preset is a pointer swap
+
+static struct preset_s currentPresetBuffer;
+static struct preset_s presetCacheBuffers[PRESET_CACHE_SIZE] EXT_RAM;
+
+struct preset_s * currentPreset=&currentPresetBuffer;
+
+static struct presetCacheEntry_s
+{
+	int8_t valid,found;
+	uint16_t number;
+	struct preset_s * preset;
+} presetCache[PRESET_CACHE_SIZE]={{.preset=&presetCacheBuffers[0]},{.preset=&presetCacheBuffers[1]}};
+
+static int8_t presetBrowseDirection=1; // +1 or -1, from the last two loads
+
+// sized for the biggest file, overcycler.conf at 16 voices: 136 keys, ~2.4KB of names and values
+#define CONFIG_MAX_ENTRIES 160 // must fit in hash slots and in uint8_t
+#define CONFIG_HASH_SIZE 512 // power of 2, at most a third full
+#define CONFIG_ARENA_SIZE 3072
+
+struct config_s
 {
-	char *name,*strValue;
-	struct loadLL_s *next;
+	uint16_t entries[CONFIG_MAX_ENTRIES]; // arena offsets of name, value follows the name
+	uint16_t entryCount;
+	
+	uint8_t hash[CONFIG_HASH_SIZE]; // open addressing, entry index+1, 0 when free
+
+	char arena[CONFIG_ARENA_SIZE];
+	uint16_t arenaUsed;
 };
 
-typedef void (*parse_callback_t)(struct loadLL_s * ll);
+// parsing borrows the USB mass storage block buffer, configs are never read while in USB disk mode
+_Static_assert(sizeof(struct config_s)<=W25Q_SECTOR_SIZE,"struct config_s must fit in the SCSI block buffer");
+
+typedef void (*parse_callback_t)(struct config_s * cfg);
 
 LOWERCODESIZE static FRESULT prepareConfigFileSave(FIL *f, const char * fn)
 {
@@ -142,25 +240,70 @@ LOWERCODESIZE static FRESULT prepareConfigFileSave(FIL *f, const char * fn)
 	return 0;
 }
 
+static inline uint16_t configHashSlot(const char * name)
+{
+	return hashBytes(HASH_INIT,name,strlen(name))&(CONFIG_HASH_SIZE-1);
+}
+
+static inline const char * configName(struct config_s * cfg, uint16_t slot)
+{
+	return &cfg->arena[cfg->entries[cfg->hash[slot]-1]];
+}
+
+LOWERCODESIZE static void configAddEntry(struct config_s * cfg, const char * name, const char * value)
+{
+	uint16_t slot,nameSize,valueSize;
+	
+	if(cfg->entryCount>=CONFIG_MAX_ENTRIES)
+	{
+		rprintf(0,"config: too many entries, ignoring %s\n",name);
+		return;
+	}
+	
+	slot=configHashSlot(name);
+	while(cfg->hash[slot])
+	{
+		// first occurrence of a name wins
+		if(!strcmp(configName(cfg,slot),name))
+			return;
+		slot=(slot+1)&(CONFIG_HASH_SIZE-1);
+	}
+	
+	nameSize=strlen(name)+1;
+	valueSize=strlen(value)+1;
+	
+	if(cfg->arenaUsed+nameSize+valueSize>CONFIG_ARENA_SIZE)
+	{
+		rprintf(0,"config: arena full, ignoring %s\n",name);
+		return;
+	}
+	
+	cfg->entries[cfg->entryCount]=cfg->arenaUsed;
+	memcpy(&cfg->arena[cfg->arenaUsed],name,nameSize);
+	memcpy(&cfg->arena[cfg->arenaUsed+nameSize],value,valueSize);
+	cfg->arenaUsed+=nameSize+valueSize;
+
+	cfg->hash[slot]=++cfg->entryCount;
+}
+
 LOWERCODESIZE static FRESULT parseConfigFile(const char * fn, parse_callback_t callback)
 {
 	FIL f;
 	FRESULT res;
-	struct loadLL_s *ll, *prev_ll=NULL, *first_ll=NULL;
 	char line[256];
 	char *p, *locName, *locValue;
+	struct config_s * config=(struct config_s *)SCSIGetBlockBuffer();
 	
 	res=f_open(&f,fn,FA_READ|FA_OPEN_EXISTING);
 	if(res)
 		return res;
 
+	config->entryCount=0;
+	config->arenaUsed=0;
+	memset(config->hash,0,sizeof(config->hash));
+
 	while(f_gets(line,sizeof(line),&f))
 	{
-		// alloc on stack, clear
-		
-		ll=alloca(sizeof(struct loadLL_s));
-		memset(ll,0,sizeof(struct loadLL_s));
-
 		// parse line
 		
 		locName=NULL;
@@ -175,7 +318,7 @@ LOWERCODESIZE static FRESULT parseConfigFile(const char * fn, parse_callback_t c
 		if(p)
 		{
 			*p--='\0';
-			while(isspace(*p)) *p--='\0';
+			while(p>=line && isspace(*p)) *p--='\0'; // blank lines
 		}
 		
 			// trim name left
@@ -188,56 +331,47 @@ LOWERCODESIZE static FRESULT parseConfigFile(const char * fn, parse_callback_t c
 			locValue=p+1;
 			
 			// trim name right
-			while(isspace(*p) || *p=='=') *p--='\0';
+			while(p>=locName && (isspace(*p) || *p=='=')) *p--='\0';
 
 			// trim value left
 			while(isspace(*locValue)) ++locValue;
 		}
 		
-		// alloc strings
-		
-		if(locName)
-		{
-			ll->name=alloca(strlen(locName)+1);
-			strcpy(ll->name,locName);
-		}
+		// lines without value can't be looked up
 		
 		if(locValue)
-		{
-			ll->strValue=alloca(strlen(locValue)+1);
-			strcpy(ll->strValue,locValue);
-		}
-		
-		// handle linked list
-		
-		if(!first_ll)
-			first_ll=ll;
-		
-		if(prev_ll)
-			prev_ll->next=ll;
-		prev_ll=ll;
+			configAddEntry(config,locName,locValue);
 	}
 	
-	if(callback) callback(first_ll);
+	if(callback) callback(config);
 	
 	f_close(&f);
 	
 	return 0;
 }
 
-LOWERCODESIZE static const char * getStrValue(struct loadLL_s *ll, const char * name)
+LOWERCODESIZE static const char * getStrValue(struct config_s * cfg, const char * name)
 {
-	while(ll && strcmp(name, ll->name)) ll=ll->next;
+	uint16_t slot;
 	
-	if(ll)
-		return ll->strValue;
-	else
+	if(!name) // unused parameter
 		return NULL;
+	
+	slot=configHashSlot(name);
+	
+	while(cfg->hash[slot])
+	{
+		if(!strcmp(configName(cfg,slot),name))
+			return configName(cfg,slot)+strlen(name)+1;
+		slot=(slot+1)&(CONFIG_HASH_SIZE-1);
+	}
+
+	return NULL;
 }
 
-LOWERCODESIZE static void getSafeStrValue(struct loadLL_s *ll, const char * name, char * value, int size, int8_t allowEmpty)
+LOWERCODESIZE static void getSafeStrValue(struct config_s *cfg, const char * name, char * value, int size, int8_t allowEmpty)
 {
-	const char *sv = getStrValue(ll,name);
+	const char *sv = getStrValue(cfg,name);
 	if(sv && value && (sv[0]!='\0' || allowEmpty))
 	{
 		value[size-1]='\0';
@@ -245,9 +379,9 @@ LOWERCODESIZE static void getSafeStrValue(struct loadLL_s *ll, const char * name
 	}
 }
 
-LOWERCODESIZE static void getIntValue(struct loadLL_s *ll, const char * name, void * value, int size)
+LOWERCODESIZE static void getIntValue(struct config_s *cfg, const char * name, void * value, int size)
 {
-	const char *sv = getStrValue(ll,name);
+	const char *sv = getStrValue(cfg,name);
 	if(sv && value)
 	{
 		int v=atoi(sv);
@@ -255,9 +389,9 @@ LOWERCODESIZE static void getIntValue(struct loadLL_s *ll, const char * name, vo
 	}
 }
 
-LOWERCODESIZE static void getSafeIntValue(struct loadLL_s *ll, const char * name, void * value, int size, int min, int max)
+LOWERCODESIZE static void getSafeIntValue(struct config_s *cfg, const char * name, void * value, int size, int min, int max)
 {
-	const char *sv = getStrValue(ll,name);
+	const char *sv = getStrValue(cfg,name);
 	if(sv && value)
 	{
 		int v=MAX(min,MIN(max,atoi(sv)));
@@ -265,56 +399,61 @@ LOWERCODESIZE static void getSafeIntValue(struct loadLL_s *ll, const char * name
 	}
 }
 
-LOWERCODESIZE static void getContinuousValue(struct loadLL_s *ll, continuousParameter_t cp)
+LOWERCODESIZE static void getContinuousValue(struct config_s *cfg, continuousParameter_t cp, struct preset_s * preset)
 {
 	const struct namedParam_s *np=&continuousParametersZeroCentered[cp];
-	int v=scan_potFrom16bits(currentPreset.continuousParameters[cp]);
-	getIntValue(ll,np->name,&v,sizeof(v));
+	int v=scan_potFrom16bits(preset->continuousParameters[cp]);
+	getIntValue(cfg,np->name,&v,sizeof(v));
 
 	if(np->param) v+=(SCAN_POT_MAX_VALUE+1)/2;
 	v=scan_potTo16bits(v);
 	
-	currentPreset.continuousParameters[cp]=MAX(0,MIN(UINT16_MAX,v));
+	preset->continuousParameters[cp]=MAX(0,MIN(UINT16_MAX,v));
 }
 
-LOWERCODESIZE static void getSteppedValue(struct loadLL_s *ll, steppedParameter_t sp)
+LOWERCODESIZE static void getSteppedValue(struct config_s *cfg, steppedParameter_t sp, struct preset_s * preset)
 {
 	const struct namedParam_s *np=&steppedParametersSteps[sp];
-	int v=currentPreset.steppedParameters[sp];
-	getIntValue(ll,np->name,&v,sizeof(v));
+	int v=preset->steppedParameters[sp];
+	getIntValue(cfg,np->name,&v,sizeof(v));
 	
-	currentPreset.steppedParameters[sp]=MAX(0,MIN(np->param-1,v));
+	preset->steppedParameters[sp]=MAX(0,MIN(np->param-1,v));
 }
 
 LOWERCODESIZE int8_t settings_load(void)
 {
-	auto void load(struct loadLL_s * ll)
+	auto void load(struct config_s * cfg)
 	{
 		char buf[32];
 
-		getSafeIntValue(ll,"presetNumber",&settings.presetNumber,sizeof(settings.presetNumber),0,999);
-		getSafeIntValue(ll,"midiReceiveChannel",&settings.midiReceiveChannel,sizeof(settings.midiReceiveChannel),-1,MIDI_CHANMASK);
-		getSafeIntValue(ll,"voiceMask",&settings.voiceMask,sizeof(settings.voiceMask),0,(1<<SYNTH_VOICE_COUNT)-1);
-		getSafeIntValue(ll,"syncMode",&settings.syncMode,sizeof(settings.syncMode),0,symCount-1);
-		getSafeIntValue(ll,"sequencerBank",&settings.sequencerBank,sizeof(settings.sequencerBank),0,SEQ_BANK_COUNT-1);
-		getSafeIntValue(ll,"seqArpClock",&settings.seqArpClock,sizeof(settings.seqArpClock),0,CLOCK_MAX_BPM);
-		getSafeIntValue(ll,"usbMIDI",&settings.usbMIDI,sizeof(settings.usbMIDI),0,1);
-		getSafeIntValue(ll,"lcdContrast",&settings.lcdContrast,sizeof(settings.lcdContrast),0,UI_MAX_LCD_CONTRAST);
+		getSafeIntValue(cfg,"presetNumber",&settings.presetNumber,sizeof(settings.presetNumber),0,999);
+		getSafeIntValue(cfg,"midiReceiveChannel",&settings.midiReceiveChannel,sizeof(settings.midiReceiveChannel),-1,MIDI_CHANMASK);
+		getSafeIntValue(cfg,"voiceMask",&settings.voiceMask,sizeof(settings.voiceMask),0,(1<<SYNTH_VOICE_COUNT)-1);
+		getSafeIntValue(cfg,"syncMode",&settings.syncMode,sizeof(settings.syncMode),0,symCount-1);
+		getSafeIntValue(cfg,"sequencerBank",&settings.sequencerBank,sizeof(settings.sequencerBank),0,SEQ_BANK_COUNT-1);
+		getSafeIntValue(cfg,"seqArpClock",&settings.seqArpClock,sizeof(settings.seqArpClock),0,CLOCK_MAX_BPM);
+		getSafeIntValue(cfg,"usbMIDI",&settings.usbMIDI,sizeof(settings.usbMIDI),0,1);
+		getSafeIntValue(cfg,"lcdContrast",&settings.lcdContrast,sizeof(settings.lcdContrast),0,UI_MAX_LCD_CONTRAST);
 
 		for(int8_t i=0;i<TUNER_CV_COUNT;++i)
 			for(int8_t j=0;j<TUNER_OCTAVE_COUNT;++j)
 			{
 				srprintf(buf,"tune_v%d_o%d",i,j);
-				getSafeIntValue(ll,buf,&settings.tunes[j][i],sizeof(settings.tunes[j][i]),0,UINT16_MAX);
+				getSafeIntValue(cfg,buf,&settings.tunes[j][i],sizeof(settings.tunes[j][i]),0,UINT16_MAX);
 			}
 	}
 	
 	settings_loadDefault();
 
 	if(parseConfigFile("/overcycler.conf",load))
+	{
+		tuner_tunesChanged();
 		return 0;
+	}
 	else
+	{
 		return 1;
+	}
 }
 
 LOWERCODESIZE void settings_save(void)
@@ -337,6 +476,32 @@ LOWERCODESIZE void settings_save(void)
 			f_printf(&f,"tune_v%d_o%d" SAVE_INT,i,j,settings.tunes[j][i]);
 
 	f_close(&f);
+
+	settingsSave.timeout=UINT32_MAX;
+	++settingsSave.writes;
+
+#ifdef DEBUG
+	rprintf(0,"settings saved, %d requests, %d writes saved\n",settingsSave.requests,settingsSave.requests-settingsSave.writes);
+#endif		
+}
+
+void settings_requestSave(void)
+{
+	// (re)start the idle period, interrupt safe, no flash access
+	settingsSave.timeout=currentTick+SETTINGS_SAVE_DELAY;
+	++settingsSave.requests;
+}
+
+void settings_flush(void)
+{
+	if(settingsSave.timeout!=UINT32_MAX)
+		settings_save();
+}
+
+void settings_update(void)
+{
+	if(currentTick>settingsSave.timeout)
+		settings_save();
 }
 
 LOWERCODESIZE void settings_loadDefault(void)
@@ -351,18 +516,45 @@ LOWERCODESIZE void settings_loadDefault(void)
 	tuner_init(); // use theoretical tuning
 }
 
+LOWERCODESIZE static int8_t readSequencerFileHeader(FIL * f, struct sequencerFileHeader_s * h)
+{
+	UINT br;
+	
+	return !f_read(f,h,sizeof(*h),&br) && br==sizeof(*h) &&
+			h->magic==SEQUENCER_FILE_MAGIC && h->version==SEQUENCER_FILE_VERSION &&
+			h->slotSize==SEQ_NOTE_MEMORY && h->slotCount==SEQUENCER_FILE_SLOT_COUNT;
+}
+
 LOWERCODESIZE int8_t storage_loadSequencer(int8_t track, uint8_t * data, uint8_t size)
 {
-	auto void load(struct loadLL_s * ll)
+	auto void load(struct config_s * cfg)
 	{
 		char buf[32];
 		for(uint8_t i=0;i<size;++i)
 		{
 			srprintf(buf,"step%02x",i);
-			getSafeIntValue(ll,buf,&data[i],sizeof(data[i]),0,UINT8_MAX);
+			getSafeIntValue(cfg,buf,&data[i],sizeof(data[i]),0,UINT8_MAX);
 		}
 	}
 
+	FIL f;
+	UINT br;
+	struct sequencerFileHeader_s h;
+	int slot=settings.sequencerBank*SEQ_TRACK_COUNT+track;
+	
+	if(!f_open(&f,SEQUENCER_FILE,FA_READ|FA_OPEN_EXISTING))
+	{
+		int8_t loaded=readSequencerFileHeader(&f,&h) && h.offsets[slot] &&
+				!f_lseek(&f,h.offsets[slot]) && !f_read(&f,data,size,&br) && br==size;
+		
+		f_close(&f);
+		
+		if(loaded)
+			return 1;
+	}
+	
+	// track never saved in the bank file, try the older one file per track format
+
 	char fn[256];
 	srprintf(fn,SYNTH_SEQUENCES_PATH "/sequence_%02d%c.conf",settings.sequencerBank,'a'+track);
 	if(parseConfigFile(fn,load))
@@ -374,55 +566,305 @@ LOWERCODESIZE int8_t storage_loadSequencer(int8_t track, uint8_t * data, uint8_t
 LOWERCODESIZE void storage_saveSequencer(int8_t track, uint8_t * data, uint8_t size)
 {
 	FIL f;
-	char buf[256];
+	UINT bw;
+	struct sequencerFileHeader_s h;
+	int slot=settings.sequencerBank*SEQ_TRACK_COUNT+track;
 	
 	f_mkdir(SYNTH_SEQUENCES_PATH);
 	
-	srprintf(buf,SYNTH_SEQUENCES_PATH "/sequence_%02d%c.conf",settings.sequencerBank,'a'+track);
-	if(prepareConfigFileSave(&f,buf))
+	if(f_open(&f,SEQUENCER_FILE,FA_READ|FA_WRITE|FA_OPEN_ALWAYS))
+		return;
+	
+	if(!readSequencerFileHeader(&f,&h))
+	{
+		// new or unusable file, start with all tracks empty
+		memset(&h,0,sizeof(h));
+		h.magic=SEQUENCER_FILE_MAGIC;
+		h.version=SEQUENCER_FILE_VERSION;
+		h.slotSize=SEQ_NOTE_MEMORY;
+		h.slotCount=SEQUENCER_FILE_SLOT_COUNT;
+	}
+	else if(h.offsets[slot])
+	{
+		// track already has its slot, only its sector gets rewritten
+		f_lseek(&f,h.offsets[slot]);
+		f_write(&f,data,size,&bw);
+		f_close(&f);
 		return;
+	}
+	
+	// first save of this track: data first, then the header pointing to it
+	
+	f_lseek(&f,(slot+1)*SEQ_NOTE_MEMORY);
+	f_write(&f,data,size,&bw);
+	
+	h.offsets[slot]=(slot+1)*SEQ_NOTE_MEMORY;
+	f_lseek(&f,0);
+	f_write(&f,&h,sizeof(h),&bw);
+	
+	f_close(&f);
+}
+
+LOWERCODESIZE static uint32_t hashPresetSchema(uint16_t cpc, uint16_t spc)
+{
+	uint32_t h=HASH_INIT;
+	
+	// parameters are only ever appended, so a file from an older firmware
+	// has the same hash on its own parameter range
+	
+	for(continuousParameter_t cp=0;cp<cpc;++cp)
+	{
+		const struct namedParam_s *np=&continuousParametersZeroCentered[cp];
+		if(np->name) h=hashBytes(h,np->name,strlen(np->name)+1);
+		h=hashBytes(h,&np->param,sizeof(np->param));
+	}
+
+	for(steppedParameter_t sp=0;sp<spc;++sp)
+	{
+		const struct namedParam_s *np=&steppedParametersSteps[sp];
+		if(np->name) h=hashBytes(h,np->name,strlen(np->name)+1);
+		h=hashBytes(h,&np->param,sizeof(np->param));
+	}
+	
+	return h;
+}
+
+LOWERCODESIZE static int8_t loadBinaryPreset(uint16_t number, struct preset_s * preset)
+{
+	FIL f;
+	UINT br;
+	char fn[256];
+	struct presetBinHeader_s h;
+	uint8_t *p;
+	uint32_t size;
+	uint16_t v;
+	uint8_t * presetBinBuffer=SCSIGetBlockBuffer();
+	
+	srprintf(fn,SYNTH_PRESETS_PATH "/preset_%04d.bin",number);
+	if(f_open(&f,fn,FA_READ|FA_OPEN_EXISTING))
+		return 0;
+	
+	br=0;
+	f_read(&f,presetBinBuffer,PRESET_BIN_SIZE,&br);
+	f_close(&f);
+	
+	// validate
+	
+	if(br<sizeof(h))
+		return 0;
+	
+	memcpy(&h,presetBinBuffer,sizeof(h));
+
+	if(h.magic!=PRESET_BIN_MAGIC || h.version!=PRESET_BIN_VERSION || h.headerSize!=sizeof(h) ||
+			h.cpCount>cpCount || h.spCount>spCount || h.voiceCount>SYNTH_VOICE_COUNT || h.abxCount!=abxCount ||
+			h.nameSize!=sizeof(preset->presetName) || h.filenameSize!=MAX_FILENAME)
+		return 0;
+	
+	size=h.nameSize+2*abxCount*MAX_FILENAME+h.cpCount*sizeof(uint16_t)+h.spCount+h.voiceCount;
+	p=&presetBinBuffer[sizeof(h)];
+
+	if(br!=sizeof(h)+size || h.payloadHash!=hashBytes(HASH_INIT,p,size) || h.schemaHash!=hashPresetSchema(h.cpCount,h.spCount))
+		return 0;
+	
+	// copy, parameters that are not in the file keep their default values
+	
+	memcpy(preset->presetName,p,h.nameSize);
+	preset->presetName[h.nameSize-1]='\0';
+	p+=h.nameSize;
+	
+	for(abx_t abx=0;abx<abxCount;++abx)
+	{
+		memcpy(preset->oscBank[abx],p,MAX_FILENAME);
+		preset->oscBank[abx][MAX_FILENAME-1]='\0';
+		p+=MAX_FILENAME;
+		memcpy(preset->oscWave[abx],p,MAX_FILENAME);
+		preset->oscWave[abx][MAX_FILENAME-1]='\0';
+		p+=MAX_FILENAME;
+	}
+	
+	for(continuousParameter_t cp=0;cp<h.cpCount;++cp)
+	{
+		memcpy(&v,p,sizeof(v));
+		p+=sizeof(v);
+		if(continuousParametersZeroCentered[cp].name)
+			preset->continuousParameters[cp]=v;
+	}
+
+	for(steppedParameter_t sp=0;sp<h.spCount;++sp)
+	{
+		if(steppedParametersSteps[sp].name)
+			preset->steppedParameters[sp]=MIN(steppedParametersSteps[sp].param-1,*p);
+		++p;
+	}
 
-	for(uint8_t i=0;i<size;++i)
-		f_printf(&f,"step%02x" SAVE_INT,i,data[i]);
+	memcpy(preset->voicePattern,p,h.voiceCount);
 	
+	return 1;
+}
+
+LOWERCODESIZE static void saveBinaryPreset(uint16_t number)
+{
+	FIL f;
+	UINT bw;
+	char fn[256];
+	struct presetBinHeader_s h;
+	uint8_t *p;
+	uint8_t * presetBinBuffer=SCSIGetBlockBuffer();
+	
+	// payload
+	
+	p=&presetBinBuffer[sizeof(h)];
+	
+	memcpy(p,currentPreset->presetName,sizeof(currentPreset->presetName));
+	p+=sizeof(currentPreset->presetName);
+
+	for(abx_t abx=0;abx<abxCount;++abx)
+	{
+		memcpy(p,currentPreset->oscBank[abx],MAX_FILENAME);
+		p+=MAX_FILENAME;
+		memcpy(p,currentPreset->oscWave[abx],MAX_FILENAME);
+		p+=MAX_FILENAME;
+	}
+	
+	memcpy(p,currentPreset->continuousParameters,sizeof(currentPreset->continuousParameters));
+	p+=sizeof(currentPreset->continuousParameters);
+	memcpy(p,currentPreset->steppedParameters,sizeof(currentPreset->steppedParameters));
+	p+=sizeof(currentPreset->steppedParameters);
+	memcpy(p,currentPreset->voicePattern,sizeof(currentPreset->voicePattern));
+	
+	// header
+	
+	memset(&h,0,sizeof(h));
+	h.magic=PRESET_BIN_MAGIC;
+	h.version=PRESET_BIN_VERSION;
+	h.headerSize=sizeof(h);
+	h.cpCount=cpCount;
+	h.spCount=spCount;
+	h.voiceCount=SYNTH_VOICE_COUNT;
+	h.abxCount=abxCount;
+	h.nameSize=sizeof(currentPreset->presetName);
+	h.filenameSize=MAX_FILENAME;
+	h.schemaHash=hashPresetSchema(cpCount,spCount);
+	h.payloadHash=hashBytes(HASH_INIT,&presetBinBuffer[sizeof(h)],PRESET_BIN_SIZE-sizeof(h));
+	memcpy(presetBinBuffer,&h,sizeof(h));
+
+	srprintf(fn,SYNTH_PRESETS_PATH "/preset_%04d.bin",number);
+	if(f_open(&f,fn,FA_WRITE|FA_CREATE_ALWAYS))
+		return;
+	
+	f_write(&f,presetBinBuffer,PRESET_BIN_SIZE,&bw);
 	f_close(&f);
 }
 
-LOWERCODESIZE int8_t preset_loadCurrent(uint16_t number)
+LOWERCODESIZE static void resetPerformanceControls(void)
+{
+	// reset wheels/pressure
+	synth_pressureEvent(0);
+	synth_wheelEvent(0,0,3);
+}
+
+LOWERCODESIZE static void loadDefaultPreset(struct preset_s * preset, int8_t makeSound)
+{
+	int8_t i;
+
+	memset(preset,0,sizeof(struct preset_s));
+
+	preset->continuousParameters[cpUnisonDetune]=512;
+	preset->continuousParameters[cpMasterTune]=HALF_RANGE;
+	preset->continuousParameters[cpDetune]=HALF_RANGE;
+
+	preset->continuousParameters[cpABaseWMod]=HALF_RANGE;
+	preset->continuousParameters[cpBBaseWMod]=HALF_RANGE;
+	preset->continuousParameters[cpWModAEnv]=HALF_RANGE;
+	preset->continuousParameters[cpWModBEnv]=HALF_RANGE;
+	preset->continuousParameters[cpCutoff]=UINT16_MAX;
+	preset->continuousParameters[cpFilEnvAmt]=HALF_RANGE;
+	preset->continuousParameters[cpAmpSus]=UINT16_MAX;
+	preset->continuousParameters[cpLFOPitchAmt]=scan_potTo16bits(100);
+	preset->continuousParameters[cpLFOFreq]=scan_potTo16bits(5*60);
+	preset->continuousParameters[cpLFO2Freq]=scan_potTo16bits(5*60);
+	preset->continuousParameters[cpAmpLevel]=HALF_RANGE;
+
+	preset->steppedParameters[spBenderTarget]=modPitch;
+	preset->steppedParameters[spModwheelRange]=1; // low
+	preset->steppedParameters[spChromaticPitch]=2; // octave
+	preset->steppedParameters[spAssignerPriority]=apLast;
+	preset->steppedParameters[spLFOShape]=lsTri;
+	preset->steppedParameters[spLFOTargets]=otBoth;
+	preset->steppedParameters[spLFO2Shape]=lsTri;
+	preset->steppedParameters[spLFO2Targets]=otBoth;
+	preset->steppedParameters[spPressureRange]=1; // low
+	preset->steppedParameters[spPressureTarget]=modFilter;
+
+	preset->steppedParameters[spVoiceCount]=SYNTH_VOICE_COUNT-1;
+	
+	for(i=0;i<SYNTH_VOICE_COUNT;++i)
+		preset->voicePattern[i]=(i==0)?0:ASSIGNER_NO_NOTE;	
+
+	for(abx_t abx=0;abx<abxCount;++abx)
+	{
+		if(abx<abxACrossover)
+		{
+			strcpy(preset->oscBank[abx],SYNTH_DEFAULT_MAIN_WAVE_BANK);
+			strcpy(preset->oscWave[abx],SYNTH_DEFAULT_MAIN_WAVE_NAME);
+		}
+		else
+		{
+			strcpy(preset->oscBank[abx],SYNTH_DEFAULT_XOVR_WAVE_BANK);
+			strcpy(preset->oscWave[abx],SYNTH_DEFAULT_XOVR_WAVE_NAME);
+		}
+	}
+
+	preset->loadedPresetNumber=-1;
+	strcpy(preset->presetName,"<no name>");
+
+	if(makeSound)
+	{
+		preset->continuousParameters[cpAVol]=HALF_RANGE;
+	}
+}
+
+LOWERCODESIZE void preset_loadDefault(int8_t makeSound)
+{
+	loadDefaultPreset(currentPreset,makeSound);
+}
+
+LOWERCODESIZE static int8_t decodePreset(uint16_t number, struct preset_s * preset)
 {
-	auto void load(struct loadLL_s * ll)
+	auto void load(struct config_s * cfg)
 	{
 		char buf[32];
 		
-		getSafeStrValue(ll,"presetName",currentPreset.presetName,sizeof(currentPreset.presetName),0);
+		getSafeStrValue(cfg,"presetName",preset->presetName,sizeof(preset->presetName),0);
 
 		for(abx_t abx=0;abx<abxCount;++abx)
 		{
 			srprintf(buf,"bank%d",abx);
-			getSafeStrValue(ll,buf,currentPreset.oscBank[abx],MAX_FILENAME,0);
+			getSafeStrValue(cfg,buf,preset->oscBank[abx],MAX_FILENAME,0);
 			srprintf(buf,"wave%d",abx);
-			getSafeStrValue(ll,buf,currentPreset.oscWave[abx],MAX_FILENAME,0);
+			getSafeStrValue(cfg,buf,preset->oscWave[abx],MAX_FILENAME,0);
 		}
 
 		for(continuousParameter_t cp=0;cp<cpCount;++cp)
-			getContinuousValue(ll,cp);
+			getContinuousValue(cfg,cp,preset);
 
 		for(steppedParameter_t sp=0;sp<spCount;++sp)
-			getSteppedValue(ll,sp);
+			getSteppedValue(cfg,sp,preset);
 
 		for(int8_t i=0;i<SYNTH_VOICE_COUNT;++i)
 		{
 			srprintf(buf,"voicePattern%d",i);
-			getSafeIntValue(ll,buf,&currentPreset.voicePattern[i],sizeof(currentPreset.voicePattern[i]),0,UINT8_MAX);
+			getSafeIntValue(cfg,buf,&preset->voicePattern[i],sizeof(preset->voicePattern[i]),0,UINT8_MAX);
 		}
-		
-		// reset wheels/pressure
-		synth_pressureEvent(0);
-		synth_wheelEvent(0,0,3);
 	}
 	
-	preset_loadDefault(1);
-	currentPreset.loadedPresetNumber=number;
+	loadDefaultPreset(preset,1);
+	preset->loadedPresetNumber=number;
+
+	// binary preset first, text preset is the import/export format
+	
+	if(loadBinaryPreset(number,preset))
+		return 1;
 
 	char fn[256];
 	srprintf(fn,SYNTH_PRESETS_PATH "/preset_%04d.conf",number);
@@ -432,41 +874,202 @@ LOWERCODESIZE int8_t preset_loadCurrent(uint16_t number)
 		return 1;
 }
 
+static struct presetCacheEntry_s * findCachedPreset(uint16_t number)
+{
+	for(int8_t i=0;i<PRESET_CACHE_SIZE;++i)
+		if(presetCache[i].valid && presetCache[i].number==number)
+			return &presetCache[i];
+	
+	return NULL;
+}
+
+LOWERCODESIZE int8_t preset_loadCurrent(uint16_t number)
+{
+	struct presetCacheEntry_s * pce;
+	struct preset_s * previous;
+	int8_t found;
+	
+	if(currentPreset->loadedPresetNumber>=0)
+	{
+		if(number==(currentPreset->loadedPresetNumber+1)%PRESET_COUNT)
+			presetBrowseDirection=1;
+		else if(number==(currentPreset->loadedPresetNumber+PRESET_COUNT-1)%PRESET_COUNT)
+			presetBrowseDirection=-1;
+	}
+	
+	if((pce=findCachedPreset(number)))
+	{
+		// prefetched, swap buffers, the entry gets the previous preset (maybe edited, so not valid)
+		previous=currentPreset;
+		currentPreset=pce->preset;
+		pce->preset=previous;
+		pce->valid=0;
+		found=pce->found;
+	}
+	else
+	{
+		found=decodePreset(number,currentPreset);
+	}
+	
+	if(found)
+		resetPerformanceControls();
+	
+	return found;
+}
+
+LOWERCODESIZE void preset_prefetch(void)
+{
+	int16_t wanted[PRESET_CACHE_SIZE];
+	int16_t number;
+	int8_t i,j,needed;
+	
+	// the next presets in the browsing direction, browsing one step only decodes the farthest one
+	
+	number=(currentPreset->loadedPresetNumber>=0)?currentPreset->loadedPresetNumber:settings.presetNumber;
+	for(i=0;i<PRESET_CACHE_SIZE;++i)
+		wanted[i]=(number+(i+1)*presetBrowseDirection+PRESET_COUNT)%PRESET_COUNT;
+	
+	// decode at most one preset per call, so that the main loop stays responsive
+
+	for(i=0;i<PRESET_CACHE_SIZE;++i)
+	{
+		if(findCachedPreset(wanted[i]))
+			continue;
+		
+		// reuse an entry that isn't wanted anymore
+		
+		for(j=0;j<PRESET_CACHE_SIZE;++j)
+		{
+			needed=presetCache[j].valid && 
+					(presetCache[j].number==wanted[0] || presetCache[j].number==wanted[1]);
+			
+			if(!needed)
+			{
+				presetCache[j].valid=0;
+				presetCache[j].found=decodePreset(wanted[i],presetCache[j].preset);
+				presetCache[j].number=wanted[i];
+				presetCache[j].valid=1;
+				return;
+			}
+		}
+	}
+}
+
+LOWERCODESIZE void preset_invalidateCache(void)
+{
+	for(int8_t i=0;i<PRESET_CACHE_SIZE;++i)
+		presetCache[i].valid=0;
+}
+
+static int16_t getPresetFileNumber(const char * name, const char * ext)
+{
+	char fn[32];
+	int16_t number;
+	
+	// preset_NNNN.ext
+	
+	if(strlen(name)!=11+strlen(ext) || strncasecmp(name,"preset_",7))
+		return -1;
+
+	number=atoi(&name[7]);
+	srprintf(fn,"preset_%04d%s",number,ext);
+	
+	return (number>=0 && number<PRESET_COUNT && !strcasecmp(name,fn))?number:-1;
+}
+
+LOWERCODESIZE void preset_dropStaleBinaries(void)
+{
+	DIR d;
+	FILINFO fi,bfi;
+	char lfn[32];
+	char fn[32];
+	int16_t number;
+	
+	// binary presets are loaded first; a text preset edited or removed from
+	// the PC while in USB disk mode (FAT times are then newer than the fixed
+	// get_fattime() of the synth) must win over its binary
+	
+	if(f_opendir(&d,SYNTH_PRESETS_PATH))
+		return;
+	
+	fi.lfname=lfn;
+	fi.lfsize=sizeof(lfn);
+	memset(&bfi,0,sizeof(bfi)); // no long file name needed
+
+	while(!f_readdir(&d,&fi) && fi.fname[0])
+	{
+		if((number=getPresetFileNumber(lfn[0]?lfn:fi.fname,".conf"))>=0)
+		{
+			srprintf(fn,SYNTH_PRESETS_PATH "/preset_%04d.bin",number);
+			if(f_stat(fn,&bfi) || 
+					(((uint32_t)bfi.fdate<<16)|bfi.ftime)>=(((uint32_t)fi.fdate<<16)|fi.ftime))
+				continue;
+		}
+		else if((number=getPresetFileNumber(lfn[0]?lfn:fi.fname,".bin"))>=0)
+		{
+			srprintf(fn,SYNTH_PRESETS_PATH "/preset_%04d.conf",number);
+			if(f_stat(fn,&bfi)!=FR_NO_FILE)
+				continue;
+			srprintf(fn,SYNTH_PRESETS_PATH "/preset_%04d.bin",number);
+		}
+		else
+		{
+			continue;
+		}
+		
+#ifdef DEBUG
+		rprintf(0,"dropping stale %s\n",fn);
+#endif		
+		f_unlink(fn);
+	}
+}
+
 LOWERCODESIZE void preset_saveCurrent(uint16_t number)
 {
 	FIL f;
 	char buf[256];
+	struct presetCacheEntry_s * pce;
 	
-	currentPreset.loadedPresetNumber=number;
+	currentPreset->loadedPresetNumber=number;
 
 	f_mkdir(SYNTH_PRESETS_PATH);
 	
+	saveBinaryPreset(number);
+	
+	if((pce=findCachedPreset(number)))
+	{
+		memcpy(pce->preset,currentPreset,sizeof(struct preset_s));
+		pce->found=1;
+	}
+	
+	// also export as text, for editing / sharing
+	
 	srprintf(buf,SYNTH_PRESETS_PATH "/preset_%04d.conf",number);
 	if(prepareConfigFileSave(&f,buf))
 		return;
 
-	f_printf(&f,"presetName" SAVE_STR,currentPreset.presetName);
+	f_printf(&f,"presetName" SAVE_STR,currentPreset->presetName);
 
 	for(abx_t abx=0;abx<abxCount;++abx)
 	{
-		f_printf(&f,"bank%d" SAVE_STR,abx,currentPreset.oscBank[abx]);
-		f_printf(&f,"wave%d" SAVE_STR,abx,currentPreset.oscWave[abx]);
+		f_printf(&f,"bank%d" SAVE_STR,abx,currentPreset->oscBank[abx]);
+		f_printf(&f,"wave%d" SAVE_STR,abx,currentPreset->oscWave[abx]);
 	}
 	
 	for(continuousParameter_t cp=0;cp<cpCount;++cp)
 		if(continuousParametersZeroCentered[cp].name)
 			f_printf(&f,"%s" SAVE_INT,
 				continuousParametersZeroCentered[cp].name,
-				scan_potFrom16bits(currentPreset.continuousParameters[cp]+(continuousParametersZeroCentered[cp].param?INT16_MIN:0)));
+				scan_potFrom16bits(currentPreset->continuousParameters[cp]+(continuousParametersZeroCentered[cp].param?INT16_MIN:0)));
 
 	for(steppedParameter_t sp=0;sp<spCount;++sp)
 		if(steppedParametersSteps[sp].name)
 			f_printf(&f,"%s" SAVE_INT,
 				steppedParametersSteps[sp].name,
-				currentPreset.steppedParameters[sp]);
+				currentPreset->steppedParameters[sp]);
 
 	for(int8_t i=0;i<SYNTH_VOICE_COUNT;++i)
-		f_printf(&f,"voicePattern%d" SAVE_INT,i,currentPreset.voicePattern[i]);
+		f_printf(&f,"voicePattern%d" SAVE_INT,i,currentPreset->voicePattern[i]);
 	
 	f_close(&f);
 }
@@ -476,9 +1079,15 @@ LOWERCODESIZE int8_t preset_fileExists(uint16_t number)
 	FIL f;
 	FRESULT res;
 	char fn[256];
-	srprintf(fn,SYNTH_PRESETS_PATH "/preset_%04d.conf",number);
+	srprintf(fn,SYNTH_PRESETS_PATH "/preset_%04d.bin",number);
 	
 	res=f_open(&f,fn,FA_READ|FA_OPEN_EXISTING);
+	if(res==FR_NO_FILE)
+	{
+		srprintf(fn,SYNTH_PRESETS_PATH "/preset_%04d.conf",number);
+		res=f_open(&f,fn,FA_READ|FA_OPEN_EXISTING);
+	}
+	
 	if(res)
 		return res!=FR_NO_FILE;
 
@@ -486,63 +1095,3 @@ LOWERCODESIZE int8_t preset_fileExists(uint16_t number)
 	return 1;
 }
 
-LOWERCODESIZE void preset_loadDefault(int8_t makeSound)
-{
-	int8_t i;
-
-	memset(&currentPreset,0,sizeof(struct preset_s));
-
-	currentPreset.continuousParameters[cpUnisonDetune]=512;
-	currentPreset.continuousParameters[cpMasterTune]=HALF_RANGE;
-	currentPreset.continuousParameters[cpDetune]=HALF_RANGE;
-
-	currentPreset.continuousParameters[cpABaseWMod]=HALF_RANGE;
-	currentPreset.continuousParameters[cpBBaseWMod]=HALF_RANGE;
-	currentPreset.continuousParameters[cpWModAEnv]=HALF_RANGE;
-	currentPreset.continuousParameters[cpWModBEnv]=HALF_RANGE;
-	currentPreset.continuousParameters[cpCutoff]=UINT16_MAX;
-	currentPreset.continuousParameters[cpFilEnvAmt]=HALF_RANGE;
-	currentPreset.continuousParameters[cpAmpSus]=UINT16_MAX;
-	currentPreset.continuousParameters[cpLFOPitchAmt]=scan_potTo16bits(100);
-	currentPreset.continuousParameters[cpLFOFreq]=scan_potTo16bits(5*60);
-	currentPreset.continuousParameters[cpLFO2Freq]=scan_potTo16bits(5*60);
-	currentPreset.continuousParameters[cpAmpLevel]=HALF_RANGE;
-
-	currentPreset.steppedParameters[spBenderTarget]=modPitch;
-	currentPreset.steppedParameters[spModwheelRange]=1; // low
-	currentPreset.steppedParameters[spChromaticPitch]=2; // octave
-	currentPreset.steppedParameters[spAssignerPriority]=apLast;
-	currentPreset.steppedParameters[spLFOShape]=lsTri;
-	currentPreset.steppedParameters[spLFOTargets]=otBoth;
-	currentPreset.steppedParameters[spLFO2Shape]=lsTri;
-	currentPreset.steppedParameters[spLFO2Targets]=otBoth;
-	currentPreset.steppedParameters[spPressureRange]=1; // low
-	currentPreset.steppedParameters[spPressureTarget]=modFilter;
-
-	currentPreset.steppedParameters[spVoiceCount]=SYNTH_VOICE_COUNT-1;
-	
-	for(i=0;i<SYNTH_VOICE_COUNT;++i)
-		currentPreset.voicePattern[i]=(i==0)?0:ASSIGNER_NO_NOTE;	
-
-	for(abx_t abx=0;abx<abxCount;++abx)
-	{
-		if(abx<abxACrossover)
-		{
-			strcpy(currentPreset.oscBank[abx],SYNTH_DEFAULT_MAIN_WAVE_BANK);
-			strcpy(currentPreset.oscWave[abx],SYNTH_DEFAULT_MAIN_WAVE_NAME);
-		}
-		else
-		{
-			strcpy(currentPreset.oscBank[abx],SYNTH_DEFAULT_XOVR_WAVE_BANK);
-			strcpy(currentPreset.oscWave[abx],SYNTH_DEFAULT_XOVR_WAVE_NAME);
-		}
-	}
-
-	currentPreset.loadedPresetNumber=-1;
-	strcpy(currentPreset.presetName,"<no name>");
-
-	if(makeSound)
-	{
-		currentPreset.continuousParameters[cpAVol]=HALF_RANGE;
-	}
-}
@@ -26,6 +26,8 @@ typedef enum
 	cpWModAtt=44,cpWModDec=45,cpWModSus=46,cpWModRel=47,
 	cpWModBEnv=48,cpWModVelocity=49,
 	cpAmpLevel=50,
+	
+	cpFilDly=51,cpFilHld=52,cpAmpDly=53,cpAmpHld=54,cpWModDly=55,cpWModHld=56,
 
 	// /!\ this must stay last
 	cpCount
@@ -63,11 +65,31 @@ typedef enum
 	spBXOvrBank_Unsaved=38,spBXOvrWave_Unsaved=39,
 			
 	spLFOTrig=40, spLFO2Trig=41,
+	
+	spGlideMode=42,
+	
+	spFilEnvCurves=43,spAmpEnvCurves=44,spWModEnvCurves=45,
+	
+	spAmpEnvDigital=46,
+	
+	spLFOPerVoice=47,spLFO2PerVoice=48,
+	
+	spLFOSync=49,spLFO2Sync=50,
 
 	// /!\ this must stay last
 	spCount
 } steppedParameter_t;
 
+typedef enum
+{
+	gmLinear=0,gmExponential=1
+} glideMode_t;
+
+typedef enum
+{
+	ecAttack=1,ecDecay=2,ecRelease=4
+} envCurveFlip_t; // spXXXEnvCurves flags, segments whose curve is the opposite of the envelope type
+
 typedef enum
 {
 	ptOther, ptBass, ptPad, ptStrings, ptBrass, ptKeys, ptLead, ptArpeggios
@@ -78,6 +100,8 @@ typedef enum
 	psOther, psNeutral, psClean, psRealistic, psSilky, psRaw, psHeavy, psCrunchy
 }presetStyle_t;
 
+#define PRESET_COUNT 1000
+
 struct settings_s
 {
 	uint16_t tunes[TUNER_OCTAVE_COUNT][TUNER_CV_COUNT];
@@ -85,7 +109,7 @@ struct settings_s
 	uint16_t presetNumber;
 	
 	int8_t midiReceiveChannel; // -1: omni / 0-15: channel 1-16
-	uint8_t voiceMask;
+	uint16_t voiceMask;
 	
 	int8_t syncMode;
 	int8_t usbMIDI;
@@ -117,17 +141,23 @@ struct namedParam_s
 };
 
 extern struct settings_s settings;
-extern struct preset_s currentPreset;
+extern struct preset_s * currentPreset; // one of the preset buffers, prefetched presets are swapped in, see storage.c
 
 extern const struct namedParam_s continuousParametersZeroCentered[cpCount];
 extern const struct namedParam_s steppedParametersSteps[spCount];
 
 int8_t settings_load(void);
 void settings_save(void);
+void settings_requestSave(void); // deferred save, coalesces changes, safe inside BLOCK_INT
+void settings_flush(void); // writes a pending save now
+void settings_update(void); // main loop
 
 int8_t preset_loadCurrent(uint16_t number);
 void preset_saveCurrent(uint16_t number);
 int8_t preset_fileExists(uint16_t number);
+void preset_prefetch(void); // main loop, decodes the next presets in the browsing direction
+void preset_invalidateCache(void);
+void preset_dropStaleBinaries(void); // after USB disk mode, text presets edited on the PC win
 
 void preset_loadDefault(int8_t makeSound);
 void settings_loadDefault(void);
@@ -29,8 +29,36 @@
 #define MAX_BANKS 128
 #define MAX_BANK_WAVES 256
 
+#define WAVE_INDEX_PATH "/WAVEIDX"
+#define WAVE_INDEX_MAGIC 0x58444957 // "WIDX"
+#define WAVE_INDEX_VERSION 2
+
+#define WAVE_SLOT_COUNT (abxCount+1) // one table per oscillator + one swap buffer, see waveData.sampleData
+#define WAVE_SLOT_SIZE (WTOSC_SAMPLE_COUNT+RESAMPLE_SINC_TAPS/2) // headroom for in place resampling
+#define WAVE_LOADER_SLICE 256 // samples read per main loop iteration (one sector)
+
+#define GLIDE_FRAC_SHIFT 15
+#define GLIDE_EXP_TIME_CONSTANTS 3 // exponential glide time ~ linear glide time over an octave
+
 volatile uint32_t currentTick=0; // 500hz
 
+// sorted directory listing, one file per directory in WAVE_INDEX_PATH
+// FAT doesn't update directory dates when files change, indexes are trusted until
+// synth_invalidateWaveIndexes() deletes them on leaving USB disk mode, the only way wave data can change
+struct waveIndexHeader_s
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t entrySize;
+	uint16_t count;
+	char path[128]; // indexed directory, file names are hashes
+};
+
+struct waveIndexEntry_s
+{
+	char name[MAX_FILENAME];
+};
+
 static struct
 {
 	int bankCount;
@@ -43,7 +71,33 @@ static struct
 	abx_t curWaveABX;
 	char curWaveBank[128];
 	
-	uint16_t sampleData[abxCount][WTOSC_SAMPLE_COUNT];
+	// processed waveforms, oscillators point directly into them
+	// abxCount slots are being played, the spare one receives the next waveform while the old one keeps playing,
+	// so the last replaced table stays around and switching back to it costs no load
+	// each slot is ~4.8KB and there is no RAM left for more, the spare took the place of the former on-stack decode buffer
+	uint16_t sampleData[WAVE_SLOT_COUNT][WAVE_SLOT_SIZE];
+	struct
+	{
+		char bank[MAX_FILENAME];
+		char wave[MAX_FILENAME];
+		uint8_t bankNum,waveNum;
+		uint8_t channel,channelCount;
+		int8_t valid;
+		uint32_t lastUse;
+	} slots[WAVE_SLOT_COUNT];
+	int8_t abxSlot[abxCount];
+	uint32_t useCounter,reuses,loads;
+	
+	// background loader, fills a free slot over several main loop iterations
+	struct
+	{
+		wave_reader wr;
+		int8_t active;
+		abx_t abx;
+		int8_t slot;
+		int32_t smpCnt,smpPos;
+		uint8_t pending; // abx bitmask
+	} loader;
 
 	DIR curDir;
 	FILINFO curFile;
@@ -57,10 +111,12 @@ static struct
 	struct adsr_s ampEnvs[SYNTH_VOICE_COUNT];
 	struct adsr_s wmodEnvs[SYNTH_VOICE_COUNT];
 	struct lfo_s lfo[2];
+	struct lfo_s voiceLfo[2][SYNTH_VOICE_COUNT]; // used instead of lfo[] for voice targets when spLFOPerVoice / spLFO2PerVoice
 	
-	uint16_t oscANoteCV[SYNTH_VOICE_COUNT];
-	uint16_t oscBNoteCV[SYNTH_VOICE_COUNT];
-	uint16_t filterNoteCV[SYNTH_VOICE_COUNT]; 
+	// fixed point (GLIDE_FRAC_SHIFT), for glide precision
+	uint32_t oscANoteCV[SYNTH_VOICE_COUNT];
+	uint32_t oscBNoteCV[SYNTH_VOICE_COUNT];
+	uint32_t filterNoteCV[SYNTH_VOICE_COUNT]; 
 	
 	uint16_t oscATargetCV[SYNTH_VOICE_COUNT];
 	uint16_t oscBTargetCV[SYNTH_VOICE_COUNT];
@@ -71,7 +127,8 @@ static struct
 		int16_t benderAmount;
 		uint16_t modwheelAmount;
 		uint16_t pressureAmount;
-		int16_t glideAmount;
+		uint32_t glideIncrement; // linear glide, per CV update
+		uint16_t glideCoef; // exponential glide, one-pole coefficient
 		int8_t gliding;
 
 		uint32_t modulationDelayStart;
@@ -113,6 +170,12 @@ const abx_t sp2abx[spCount] =
 	
 	/*BXOvrBank*/abxBCrossover,
 	/*BXOvrWave*/abxBCrossover,
+	
+	/*LFOTrig*/abxNone,/*LFO2Trig*/abxNone,/*GlideMode*/abxNone,
+	/*FilEnvCurves*/abxNone,/*AmpEnvCurves*/abxNone,/*WModEnvCurves*/abxNone,
+	/*AmpEnvDigital*/abxNone,
+	/*LFOPerVoice*/abxNone,/*LFO2PerVoice*/abxNone,
+	/*LFOSync*/abxNone,/*LFO2Sync*/abxNone,
 };
 
 const char * notesNames[12]=
@@ -132,9 +195,9 @@ static int32_t getStaticCV(cv_t cv)
 	
 	if(mod!=modNone)
 	{
-		if(currentPreset.steppedParameters[spBenderTarget]==mod)
+		if(currentPreset->steppedParameters[spBenderTarget]==mod)
 			res+=synth.partState.benderAmount;
-		if(currentPreset.steppedParameters[spPressureTarget]==mod)
+		if(currentPreset->steppedParameters[spPressureTarget]==mod)
 			res+=(int32_t)synth.partState.pressureAmount*(mod==modPitch?-1:1); // pressure to pitch goes downwards
 	}
 	
@@ -177,14 +240,14 @@ static void refreshTunedCVs(void)
 	
 	// get raw values
 
-	mTuneRaw=currentPreset.continuousParameters[cpMasterTune];
-	detuneRaw=currentPreset.continuousParameters[cpDetune];
-	baseCutoffRaw=currentPreset.continuousParameters[cpCutoff];
-	baseAPitch=currentPreset.continuousParameters[cpAFreq]>>2;
-	baseBPitch=currentPreset.continuousParameters[cpBFreq]>>2;
-	unisonDetuneRaw=currentPreset.continuousParameters[cpUnisonDetune];
-	trackRaw=currentPreset.continuousParameters[cpFilKbdAmt];
-	chrom=currentPreset.steppedParameters[spChromaticPitch];
+	mTuneRaw=currentPreset->continuousParameters[cpMasterTune];
+	detuneRaw=currentPreset->continuousParameters[cpDetune];
+	baseCutoffRaw=currentPreset->continuousParameters[cpCutoff];
+	baseAPitch=currentPreset->continuousParameters[cpAFreq]>>2;
+	baseBPitch=currentPreset->continuousParameters[cpBFreq]>>2;
+	unisonDetuneRaw=currentPreset->continuousParameters[cpUnisonDetune];
+	trackRaw=currentPreset->continuousParameters[cpFilKbdAmt];
+	chrom=currentPreset->steppedParameters[spChromaticPitch];
 
 	// compute for oscs & filters
 
@@ -241,37 +304,35 @@ static void refreshTunedCVs(void)
 		
 		// glide
 		
-		if(synth.partState.gliding)
-		{
-			synth.oscATargetCV[v]=cva;
-			synth.oscBTargetCV[v]=cvb;
-			synth.filterTargetCV[v]=cvf;
+		synth.oscATargetCV[v]=cva;
+		synth.oscBTargetCV[v]=cvb;
+		synth.filterTargetCV[v]=cvf;
 
-			if(trackRaw<SCAN_POT_DEAD_ZONE)
-				synth.filterNoteCV[v]=cvf; // no glide if no tracking for filter
-		}
-		else			
+		if(!synth.partState.gliding)
 		{
-			synth.oscANoteCV[v]=cva;
-			synth.oscBNoteCV[v]=cvb;
-			synth.filterNoteCV[v]=cvf;
+			synth.oscANoteCV[v]=(uint32_t)cva<<GLIDE_FRAC_SHIFT;
+			synth.oscBNoteCV[v]=(uint32_t)cvb<<GLIDE_FRAC_SHIFT;
 		}
+
+		if(!synth.partState.gliding || trackRaw<SCAN_POT_DEAD_ZONE)
+			synth.filterNoteCV[v]=(uint32_t)cvf<<GLIDE_FRAC_SHIFT; // no glide if no tracking for filter
 				
 	}
 }
 
 static void refreshAssignerSettings(void)
 {
-	static const uint8_t vc2msk[7]={1,3,7,15,31,63};
+	uint16_t vcMask=(2<<currentPreset->steppedParameters[spVoiceCount])-1;
  
-	assigner_setPattern(currentPreset.voicePattern,currentPreset.steppedParameters[spUnison]);
-	assigner_setPriority(currentPreset.steppedParameters[spAssignerPriority]);
-	assigner_setVoiceMask(vc2msk[currentPreset.steppedParameters[spVoiceCount]]&settings.voiceMask);
+	assigner_setPattern(currentPreset->voicePattern,currentPreset->steppedParameters[spUnison]);
+	assigner_setPriority(currentPreset->steppedParameters[spAssignerPriority]);
+	assigner_setVoiceMask(vcMask&settings.voiceMask);
 }
 
 static void refreshEnvSettings(int8_t type)
 {
-	uint16_t atk,dec,sus,rel;
+	uint16_t dly,atk,hld,dec,sus,rel;
+	uint8_t curves,expStages;
 	int8_t slow,lin,loop;
 	int8_t i;
 	struct adsr_s * a;
@@ -282,43 +343,62 @@ static void refreshEnvSettings(int8_t type)
 		{
 		case 0:
 			a=&synth.ampEnvs[i];
-			slow=currentPreset.steppedParameters[spAmpEnvSlow];
-			lin=currentPreset.steppedParameters[spAmpEnvLin];
-			loop=currentPreset.steppedParameters[spAmpEnvLoop];
-
-			atk=currentPreset.continuousParameters[cpAmpAtt];
-			dec=currentPreset.continuousParameters[cpAmpDec];
-			sus=currentPreset.continuousParameters[cpAmpSus];
-			rel=currentPreset.continuousParameters[cpAmpRel];
+			slow=currentPreset->steppedParameters[spAmpEnvSlow];
+			lin=currentPreset->steppedParameters[spAmpEnvLin];
+			loop=currentPreset->steppedParameters[spAmpEnvLoop];
+			curves=currentPreset->steppedParameters[spAmpEnvCurves];
+
+			dly=currentPreset->continuousParameters[cpAmpDly];
+			atk=currentPreset->continuousParameters[cpAmpAtt];
+			hld=currentPreset->continuousParameters[cpAmpHld];
+			dec=currentPreset->continuousParameters[cpAmpDec];
+			sus=currentPreset->continuousParameters[cpAmpSus];
+			rel=currentPreset->continuousParameters[cpAmpRel];
 			break;
 		case 1:
 			a=&synth.filEnvs[i];
-			slow=currentPreset.steppedParameters[spFilEnvSlow];
-			lin=currentPreset.steppedParameters[spFilEnvLin];
-			loop=currentPreset.steppedParameters[spFilEnvLoop];
-
-			atk=currentPreset.continuousParameters[cpFilAtt];
-			dec=currentPreset.continuousParameters[cpFilDec];
-			sus=currentPreset.continuousParameters[cpFilSus];
-			rel=currentPreset.continuousParameters[cpFilRel];
+			slow=currentPreset->steppedParameters[spFilEnvSlow];
+			lin=currentPreset->steppedParameters[spFilEnvLin];
+			loop=currentPreset->steppedParameters[spFilEnvLoop];
+			curves=currentPreset->steppedParameters[spFilEnvCurves];
+
+			dly=currentPreset->continuousParameters[cpFilDly];
+			atk=currentPreset->continuousParameters[cpFilAtt];
+			hld=currentPreset->continuousParameters[cpFilHld];
+			dec=currentPreset->continuousParameters[cpFilDec];
+			sus=currentPreset->continuousParameters[cpFilSus];
+			rel=currentPreset->continuousParameters[cpFilRel];
 			break;
 		case 2:
 			a=&synth.wmodEnvs[i];
-			slow=currentPreset.steppedParameters[spWModEnvSlow];
-			lin=currentPreset.steppedParameters[spWModEnvLin];
-			loop=currentPreset.steppedParameters[spWModEnvLoop];
-
-			atk=currentPreset.continuousParameters[cpWModAtt];
-			dec=currentPreset.continuousParameters[cpWModDec];
-			sus=currentPreset.continuousParameters[cpWModSus];
-			rel=currentPreset.continuousParameters[cpWModRel];
+			slow=currentPreset->steppedParameters[spWModEnvSlow];
+			lin=currentPreset->steppedParameters[spWModEnvLin];
+			loop=currentPreset->steppedParameters[spWModEnvLoop];
+			curves=currentPreset->steppedParameters[spWModEnvCurves];
+
+			dly=currentPreset->continuousParameters[cpWModDly];
+			atk=currentPreset->continuousParameters[cpWModAtt];
+			hld=currentPreset->continuousParameters[cpWModHld];
+			dec=currentPreset->continuousParameters[cpWModDec];
+			sus=currentPreset->continuousParameters[cpWModSus];
+			rel=currentPreset->continuousParameters[cpWModRel];
 			break;
 		default:
 			return;
 		}
 		
+		// per segment curves are flipped from the envelope type
+		expStages=(lin)?0:ADSR_EXP_ALL;
+		if(curves&ecAttack)
+			expStages^=ADSR_EXP_ATTACK;
+		if(curves&ecDecay)
+			expStages^=ADSR_EXP_DECAY;
+		if(curves&ecRelease)
+			expStages^=ADSR_EXP_RELEASE;
+		
 		adsr_setSpeedShift(a,(slow)?4:2);
-		adsr_setShape(a,(lin)?0:1,loop);
+		adsr_setShape(a,expStages,loop);
+		adsr_setDelayHoldCVs(a,dly,hld);
 		adsr_setCVs(a,atk,dec,sus,rel,0,0x0f);
 	}
 }
@@ -329,18 +409,21 @@ static void refreshLfoSettings(void)
 	uint16_t lfoAmt,lfo2Amt,dlyAmt;
 	uint32_t elapsed;
 
-	lfo_setShape(&synth.lfo[0],currentPreset.steppedParameters[spLFOShape],lt2per[currentPreset.steppedParameters[spLFOTrig]]);
-	lfo_setShape(&synth.lfo[1],currentPreset.steppedParameters[spLFO2Shape],lt2per[currentPreset.steppedParameters[spLFO2Trig]]);
+	lfo_setShape(&synth.lfo[0],currentPreset->steppedParameters[spLFOShape],lt2per[currentPreset->steppedParameters[spLFOTrig]]);
+	lfo_setShape(&synth.lfo[1],currentPreset->steppedParameters[spLFO2Shape],lt2per[currentPreset->steppedParameters[spLFO2Trig]]);
+	
+	lfo_setSpeedShift(&synth.lfo[0],currentPreset->steppedParameters[spLFOSpeed]);
+	lfo_setSpeedShift(&synth.lfo[1],currentPreset->steppedParameters[spLFO2Speed]);
 	
-	lfo_setSpeedShift(&synth.lfo[0],currentPreset.steppedParameters[spLFOSpeed]);
-	lfo_setSpeedShift(&synth.lfo[1],currentPreset.steppedParameters[spLFO2Speed]);
+	lfo_setSync(&synth.lfo[0],currentPreset->steppedParameters[spLFOSync]!=0,LFO_SYNC_MAX_SHIFT+1-currentPreset->steppedParameters[spLFOSync]);
+	lfo_setSync(&synth.lfo[1],currentPreset->steppedParameters[spLFO2Sync]!=0,LFO_SYNC_MAX_SHIFT+1-currentPreset->steppedParameters[spLFO2Sync]);
 
 	// wait modulationDelayTickCount then progressively increase over
 	// modulationDelayTickCount time, following an exponential curve
 	dlyAmt=0;
 	if(synth.partState.modulationDelayStart!=UINT32_MAX)
 	{
-		if(currentPreset.continuousParameters[cpModDelay]<SCAN_POT_DEAD_ZONE)
+		if(currentPreset->continuousParameters[cpModDelay]<SCAN_POT_DEAD_ZONE)
 		{
 			dlyAmt=UINT16_MAX;
 		}
@@ -354,32 +437,61 @@ static void refreshLfoSettings(void)
 		}
 	}
 
-	lfoAmt=currentPreset.continuousParameters[cpLFOAmt];
-	if(currentPreset.steppedParameters[spPressureTarget]==modLFO1)
+	lfoAmt=currentPreset->continuousParameters[cpLFOAmt];
+	if(currentPreset->steppedParameters[spPressureTarget]==modLFO1)
 		lfoAmt=satAddU16U16(lfoAmt,synth.partState.pressureAmount);
 
-	lfo2Amt=currentPreset.continuousParameters[cpLFO2Amt];
-	if(currentPreset.steppedParameters[spPressureTarget]==modLFO2)
+	lfo2Amt=currentPreset->continuousParameters[cpLFO2Amt];
+	if(currentPreset->steppedParameters[spPressureTarget]==modLFO2)
 		lfo2Amt=satAddU16U16(lfo2Amt,synth.partState.pressureAmount);
 
-	if(currentPreset.steppedParameters[spModwheelTarget]==0) // targeting lfo1?
+	if(currentPreset->steppedParameters[spModwheelTarget]==0) // targeting lfo1?
 	{
 		lfo_setCVs(&synth.lfo[0],
-				currentPreset.continuousParameters[cpLFOFreq],
+				currentPreset->continuousParameters[cpLFOFreq],
 				satAddU16U16(lfoAmt,synth.partState.modwheelAmount));
 		lfo_setCVs(&synth.lfo[1],
-				 currentPreset.continuousParameters[cpLFO2Freq],
+				 currentPreset->continuousParameters[cpLFO2Freq],
 				 scaleU16U16(lfo2Amt,dlyAmt));
 	}
 	else
 	{
 		lfo_setCVs(&synth.lfo[0],
-				currentPreset.continuousParameters[cpLFOFreq],
+				currentPreset->continuousParameters[cpLFOFreq],
 				scaleU16U16(lfoAmt,dlyAmt));
 		lfo_setCVs(&synth.lfo[1],
-				currentPreset.continuousParameters[cpLFO2Freq],
+				currentPreset->continuousParameters[cpLFO2Freq],
 				satAddU16U16(lfo2Amt,synth.partState.modwheelAmount));
 	}
+	
+	// per voice LFOs follow global LFOs settings
+	
+	for(int8_t l=0;l<2;++l)
+		if(currentPreset->steppedParameters[(l)?spLFO2PerVoice:spLFOPerVoice])
+			for(int8_t v=0;v<SYNTH_VOICE_COUNT;++v)
+			{
+				struct lfo_s * vl=&synth.voiceLfo[l][v];
+				
+				lfo_setShape(vl,synth.lfo[l].shape,synth.lfo[l].halfPeriodLimit);
+				lfo_setSpeedShift(vl,synth.lfo[l].speedShift);
+				lfo_setSync(vl,synth.lfo[l].synced,synth.lfo[l].syncShift);
+				lfo_setCVs(vl,synth.lfo[l].bpmCV,synth.lfo[l].levelCV);
+			}
+}
+
+// only from the 500hz tick: lfo_syncToClock() follows the clock rate from the position change between calls
+static void syncLfosToClock(void)
+{
+	uint32_t clockPos=clock_getPosition();
+
+	for(int8_t l=0;l<2;++l)
+	{
+		lfo_syncToClock(&synth.lfo[l],clockPos);
+		
+		if(currentPreset->steppedParameters[(l)?spLFO2PerVoice:spLFOPerVoice])
+			for(int8_t v=0;v<SYNTH_VOICE_COUNT;++v)
+				lfo_syncToClock(&synth.voiceLfo[l][v],clockPos);
+	}
 }
 
 static void refreshModulationDelay(int8_t refreshTickCount)
@@ -403,36 +515,44 @@ static void refreshModulationDelay(int8_t refreshTickCount)
 	prevAnyPressed=anyPressed;
 
 	if(refreshTickCount)
-		synth.partState.modulationDelayTickCount=exponentialCourse(UINT16_MAX-currentPreset.continuousParameters[cpModDelay],12000.0f,2500.0f);
+		synth.partState.modulationDelayTickCount=exponentialCourse(UINT16_MAX-currentPreset->continuousParameters[cpModDelay],12000.0f,2500.0f);
 }
 
-static void refreshMisc(void)
+static void refreshOscSampleData(void)
 {
-	// clock
-
-	clock_updateSpeed();
-
-	// glide
-
-	synth.partState.glideAmount=exponentialCourse(currentPreset.continuousParameters[cpGlide],11000.0f,2100.0f);
-	synth.partState.gliding=synth.partState.glideAmount<2000;
-
-	// waveforms
-	
 	for(int i=0;i<SYNTH_VOICE_COUNT;++i)
 	{
-		if (currentPreset.continuousParameters[cpAVol]>SCAN_POT_DEAD_ZONE)
-			wtosc_setSampleData(&synth.osc[i][0],waveData.sampleData[abxAMain],waveData.sampleData[abxACrossover]);
+		if (currentPreset->continuousParameters[cpAVol]>SCAN_POT_DEAD_ZONE)
+			wtosc_setSampleData(&synth.osc[i][0],synth_getWaveformData(abxAMain),synth_getWaveformData(abxACrossover));
 		else
 			wtosc_setSampleData(&synth.osc[i][0],NULL,NULL);
 			
-		if (currentPreset.continuousParameters[cpBVol]>SCAN_POT_DEAD_ZONE)
-			wtosc_setSampleData(&synth.osc[i][1],waveData.sampleData[abxBMain],waveData.sampleData[abxBCrossover]);
+		if (currentPreset->continuousParameters[cpBVol]>SCAN_POT_DEAD_ZONE)
+			wtosc_setSampleData(&synth.osc[i][1],synth_getWaveformData(abxBMain),synth_getWaveformData(abxBCrossover));
 		else
 			wtosc_setSampleData(&synth.osc[i][1],NULL,NULL);
 	}
 }
 
+static void refreshMisc(void)
+{
+	uint16_t glideAmount;
+
+	// clock
+
+	clock_updateSpeed();
+
+	// glide
+
+	glideAmount=exponentialCourse(currentPreset->continuousParameters[cpGlide],11000.0f,2100.0f); // per 500hz tick
+	synth.partState.gliding=glideAmount<2000;
+	synth.partState.glideIncrement=((uint32_t)glideAmount<<GLIDE_FRAC_SHIFT)/(DACSPI_UPDATE_HZ/TICKER_HZ);
+	synth.partState.glideCoef=MIN(UINT16_MAX,
+			((synth.partState.glideIncrement<<(16-GLIDE_FRAC_SHIFT))*GLIDE_EXP_TIME_CONSTANTS)/(12*WTOSC_CV_SEMITONE));
+
+	refreshOscSampleData();
+}
+
 static void handleBitInputs(void)
 {
 	uint32_t cur;
@@ -442,10 +562,10 @@ static void handleBitInputs(void)
 	
 	// control footswitch 
 	 
-	if(arp_getMode()==amOff && currentPreset.steppedParameters[spUnison] && !(cur&BIT_INPUT_FOOTSWITCH) && last&BIT_INPUT_FOOTSWITCH)
+	if(arp_getMode()==amOff && currentPreset->steppedParameters[spUnison] && !(cur&BIT_INPUT_FOOTSWITCH) && last&BIT_INPUT_FOOTSWITCH)
 	{
 		assigner_latchPattern();
-		assigner_getPattern( currentPreset.voicePattern,NULL);
+		assigner_getPattern( currentPreset->voicePattern,NULL);
 	}
 	else if((cur&BIT_INPUT_FOOTSWITCH)!=(last&BIT_INPUT_FOOTSWITCH))
 	{
@@ -490,7 +610,7 @@ int32_t synth_getVisualEnvelope(int8_t voice)
 
 uint16_t * synth_getWaveformData(abx_t abx)
 {
-	return &waveData.sampleData[abx][0];
+	return &waveData.sampleData[waveData.abxSlot[abx]][0];
 }
 
 int synth_getBankCount(void)
@@ -527,6 +647,123 @@ int8_t synth_getWaveName(int waveIndex, char * res)
 	return 1;
 }
 
+static void getWaveIndexFileName(const char * path, char * fn)
+{
+	srprintf(fn,WAVE_INDEX_PATH "/%08lX.IDX",hashBytes(HASH_INIT,path,strlen(path)));
+}
+
+static int8_t readWaveIndex(const char * path, char names[][MAX_FILENAME], int maxCount, int * count)
+{
+	FIL f;
+	UINT br;
+	char fn[32];
+	struct waveIndexHeader_s h;
+	struct waveIndexEntry_s e;
+	int i;
+	
+	getWaveIndexFileName(path,fn);
+	
+	if(f_open(&f,fn,FA_READ|FA_OPEN_EXISTING))
+		return 0;
+	
+	// validate
+	
+	if(f_read(&f,&h,sizeof(h),&br) || br!=sizeof(h) ||
+			h.magic!=WAVE_INDEX_MAGIC || h.version!=WAVE_INDEX_VERSION || h.entrySize!=sizeof(e) || h.count>maxCount ||
+			strncmp(h.path,path,sizeof(h.path)))
+	{
+		f_close(&f);
+		return 0;
+	}
+	
+	for(i=0;i<h.count;++i)
+	{
+		if(f_read(&f,&e,sizeof(e),&br) || br!=sizeof(e))
+			break;
+		
+		memcpy(names[i],e.name,MAX_FILENAME);
+	}
+	
+	f_close(&f);
+	*count=i;
+
+#ifdef DEBUG
+	rprintf(0,"read index %s for %s\n",fn,path);
+#endif		
+	
+	return i==h.count;
+}
+
+static void writeWaveIndex(const char * path, char names[][MAX_FILENAME], int count)
+{
+	FIL f;
+	UINT bw;
+	char fn[32];
+	struct waveIndexHeader_s h;
+	struct waveIndexEntry_s e;
+	int i;
+	
+	if(strlen(path)>=sizeof(h.path))
+		return;
+	
+	memset(&h,0,sizeof(h));
+	h.magic=WAVE_INDEX_MAGIC;
+	h.version=WAVE_INDEX_VERSION;
+	h.entrySize=sizeof(e);
+	h.count=count;
+	strcpy(h.path,path);
+	
+	f_mkdir(WAVE_INDEX_PATH);
+	
+	getWaveIndexFileName(path,fn);
+	if(f_open(&f,fn,FA_WRITE|FA_CREATE_ALWAYS))
+		return;
+	
+	f_write(&f,&h,sizeof(h),&bw);
+
+	for(i=0;i<count;++i)
+	{
+		memcpy(e.name,names[i],MAX_FILENAME);
+		f_write(&f,&e,sizeof(e),&bw);
+	}
+	
+	f_close(&f);
+
+#ifdef DEBUG
+	rprintf(0,"wrote index for %s\n",path);
+#endif		
+}
+
+void synth_invalidateWaveIndexes(void)
+{
+	char fn[32];
+	
+	// the whole wave data might have changed, all indexes have to be rebuilt
+	
+	if(f_opendir(&waveData.curDir,WAVE_INDEX_PATH))
+		return;
+
+	while(!f_readdir(&waveData.curDir,&waveData.curFile) && waveData.curFile.fname[0])
+	{
+		srprintf(fn,WAVE_INDEX_PATH "/%s",waveData.curFile.fname);
+		f_unlink(fn);
+	}
+	
+	// force reload from directories
+	waveData.bankSorted=-1;
+	waveData.curWaveBank[0]='\0';
+}
+
+static void cancelWaveLoad(void)
+{
+	if(!waveData.loader.active)
+		return;
+	
+	wave_reader_close(&waveData.loader.wr);
+	waveData.slots[waveData.loader.slot].valid=0;
+	waveData.loader.active=0;
+}
+
 int8_t synth_refreshBankNames(int8_t sort, int8_t force)
 {
 	FRESULT res;
@@ -535,6 +772,21 @@ int8_t synth_refreshBankNames(int8_t sort, int8_t force)
 		return 1;
 	
 	waveData.bankCount=0;
+	
+	if(force) // files might have changed
+	{
+		cancelWaveLoad();
+		for(int8_t slot=0;slot<WAVE_SLOT_COUNT;++slot)
+			waveData.slots[slot].valid=0;
+	}
+	
+	if(sort && readWaveIndex(SYNTH_WAVEDATA_PATH,waveData.bankNames,MAX_BANKS,&waveData.bankCount))
+	{
+		waveData.bankSorted=sort;
+		return 1;
+	}
+	
+	waveData.bankCount=0;
 
 	if((res=f_opendir(&waveData.curDir,SYNTH_WAVEDATA_PATH)))
 	{
@@ -563,7 +815,10 @@ int8_t synth_refreshBankNames(int8_t sort, int8_t force)
 	}
 	
 	if(sort)
+	{
 		qsort(waveData.bankNames,waveData.bankCount,sizeof(waveData.bankNames[0]),stringCompare);
+		writeWaveIndex(SYNTH_WAVEDATA_PATH,waveData.bankNames,waveData.bankCount);
+	}
 	
 	waveData.bankSorted=sort;
 	
@@ -580,13 +835,23 @@ void synth_refreshCurWaveNames(abx_t abx, int8_t sort)
 	char fn[128];
 	
 	strcpy(fn,SYNTH_WAVEDATA_PATH "/");
-	strcat(fn,currentPreset.oscBank[abx]);
+	strcat(fn,currentPreset->oscBank[abx]);
 	
 	if(!strcmp(waveData.curWaveBank,fn) && waveData.curWaveSorted==sort && waveData.curWaveABX==abx) // already loaded and same state
 		return;
 	
 	waveData.curWaveCount=0;
 
+	if(sort && readWaveIndex(fn,waveData.curWaveNames,MAX_BANK_WAVES,&waveData.curWaveCount))
+	{
+		waveData.curWaveSorted=sort;
+		waveData.curWaveABX=abx;
+		strcpy(waveData.curWaveBank,fn);
+		return;
+	}
+
+	waveData.curWaveCount=0;
+
 #ifdef DEBUG
 	rprintf(0,"loading %s\n",fn);
 #endif		
@@ -618,7 +883,10 @@ void synth_refreshCurWaveNames(abx_t abx, int8_t sort)
 	}
 
 	if(sort)
+	{
 		qsort(waveData.curWaveNames,waveData.curWaveCount,sizeof(waveData.curWaveNames[0]),stringCompare);
+		writeWaveIndex(fn,waveData.curWaveNames,waveData.curWaveCount);
+	}
 
 	waveData.curWaveSorted=sort;
 	waveData.curWaveABX=abx;
@@ -629,61 +897,231 @@ void synth_refreshCurWaveNames(abx_t abx, int8_t sort)
 #endif		
 }
 
-void synth_refreshWaveforms(abx_t abx)
+static int8_t isWaveSlotFor(int8_t slot, abx_t abx)
+{
+	// stereo files give one channel to main oscillators and the other to crossover ones
+	return !strcmp(waveData.slots[slot].bank,currentPreset->oscBank[abx]) && !strcmp(waveData.slots[slot].wave,currentPreset->oscWave[abx]) &&
+			(waveData.slots[slot].channelCount<=1 || waveData.slots[slot].channel==(abx>=abxACrossover?1:0));
+}
+
+static int8_t isWaveSlotPlayed(int8_t slot)
+{
+	for(abx_t abx=0;abx<abxCount;++abx)
+		if(waveData.abxSlot[abx]==slot)
+			return 1;
+	
+	// oscillators keep the previous table until the end of their cycle
+	for(int i=0;i<SYNTH_VOICE_COUNT;++i)
+		if(wtosc_isSampleDataUsed(&synth.osc[i][0],waveData.sampleData[slot]) || wtosc_isSampleDataUsed(&synth.osc[i][1],waveData.sampleData[slot]))
+			return 1;
+	
+	return 0;
+}
+
+static int8_t findLoadedWaveSlot(abx_t abx)
+{
+	int8_t slot;
+	
+	for(slot=0;slot<WAVE_SLOT_COUNT;++slot)
+		if(waveData.slots[slot].valid && isWaveSlotFor(slot,abx))
+			return slot;
+	
+	return -1;
+}
+
+static int8_t findFreeWaveSlot(void)
+{
+	int8_t slot,oldest=-1;
+	
+	// slot that isn't played by the oscillators, in practice the swap buffer or the table that was just replaced
+	
+	for(slot=0;slot<WAVE_SLOT_COUNT;++slot)
+		if(!isWaveSlotPlayed(slot) && (oldest<0 || !waveData.slots[slot].valid || (waveData.slots[oldest].valid && waveData.slots[slot].lastUse<waveData.slots[oldest].lastUse)))
+			oldest=slot;
+	
+	return oldest;
+}
+
+static void useWaveSlot(abx_t abx, int8_t slot)
+{
+	waveData.slots[slot].lastUse=++waveData.useCounter;
+	
+	// swap (oscillators will pick it at their next cycle)
+	waveData.abxSlot[abx]=slot;
+	refreshOscSampleData();
+}
+
+static void startWaveLoad(abx_t abx)
 {
-	int i, chanOffset,bankNum,waveNum;
 	char fn[256];
-	wave_reader wr;
-	int32_t d;
-	int32_t smpCnt=0, chanCnt=0;
-	int16_t data[WTOSC_SAMPLE_COUNT];
+	int8_t slot;
+	int32_t chanCnt;
+	wave_reader * wr=&waveData.loader.wr;
+	
+	slot=findLoadedWaveSlot(abx);
+	if(slot>=0) // loaded meanwhile for another oscillator
+	{
+		waveData.loader.pending&=~(1<<abx);
+		useWaveSlot(abx,slot);
+		return;
+	}
+	
+	slot=findFreeWaveSlot();
+	if(slot<0) // oscillators are still playing all the slots, retry later
+		return;
+	
+	waveData.loader.pending&=~(1<<abx);
+	++waveData.loads;
 	
 	strcpy(fn,SYNTH_WAVEDATA_PATH "/");
-	strcat(fn,currentPreset.oscBank[abx]);
+	strcat(fn,currentPreset->oscBank[abx]);
 	strcat(fn,"/");
-	strcat(fn,currentPreset.oscWave[abx]);
+	strcat(fn,currentPreset->oscWave[abx]);
 
 #ifdef DEBUG
-	rprintf(0,"loading %s\n",fn);
+	rprintf(0,"loading %s, %d reuses %d loads\n",fn,waveData.reuses,waveData.loads);
 #endif		
 	
-	if(wave_reader_open(fn,&wr)==WR_NO_ERROR)
+	if(wave_reader_open(fn,wr)!=WR_NO_ERROR)
+		return;
+	
+	chanCnt=wave_reader_get_num_channels(wr);
+	
+	if(wave_reader_get_sample_format(wr)==WR_SF_UNSUPPORTED)
 	{
-		if(wave_reader_get_format(&wr)==1 && wave_reader_get_sample_bits(&wr)==16) // linear 16Bits PCM
-		{
-			smpCnt=wave_reader_get_num_samples(&wr);
-			smpCnt=MIN(smpCnt,WTOSC_SAMPLE_COUNT);
-		}
+		wave_reader_close(wr);
+		return;
+	}
 	
-		chanCnt=wave_reader_get_num_channels(&wr);
-		
-		wave_reader_get_samples(&wr,smpCnt,data);
-		wave_reader_close(&wr);
-		
+	strcpy(waveData.slots[slot].bank,currentPreset->oscBank[abx]);
+	strcpy(waveData.slots[slot].wave,currentPreset->oscWave[abx]);
+	waveData.slots[slot].channelCount=chanCnt;
+	waveData.slots[slot].channel=(chanCnt>1 && abx>=abxACrossover)?1:0;
+	waveData.slots[slot].valid=0;
+	
+	waveData.loader.abx=abx;
+	waveData.loader.slot=slot;
+	waveData.loader.smpCnt=MIN(wave_reader_get_num_samples(wr),WTOSC_SAMPLE_COUNT/chanCnt);
+	if(wave_reader_get_frame_size(wr)>0) // wavetable, only the first frame is used
+		waveData.loader.smpCnt=MIN(waveData.loader.smpCnt,wave_reader_get_frame_size(wr));
+	waveData.loader.smpPos=0;
+	waveData.loader.active=1;
+
 #ifdef DEBUG
-		rprintf(0,"smpCnt %d chanCnt %d\n",smpCnt,chanCnt);
+	rprintf(0,"smpCnt %d chanCnt %d\n",waveData.loader.smpCnt,chanCnt);
 #endif		
-		
-		smpCnt/=chanCnt; // we want only one channel
-		chanOffset=(chanCnt>1 && abx>=abxACrossover)?1:0;
+}
 
-		for(i=0;i<smpCnt;++i)
-		{
-			d=data[i*chanCnt+chanOffset];
-			d=(d*(INT16_MAX-WTOSC_SAMPLES_GUARD_BAND))>>15;
-			d-=INT16_MIN;
-			data[i]=d;
-		}
+static void finishWaveLoad(void)
+{
+	int i;
+	int32_t d;
+	abx_t abx=waveData.loader.abx;
+	int8_t slot=waveData.loader.slot;
+	int32_t smpCnt=waveData.loader.smpCnt;
+	int32_t chanCnt=waveData.slots[slot].channelCount;
+	int32_t chanOffset=waveData.slots[slot].channel;
+	uint16_t * sd=waveData.sampleData[slot];
+	int16_t * data=(int16_t *)&sd[WAVE_SLOT_SIZE-smpCnt*chanCnt];
+	
+	wave_reader_close(&waveData.loader.wr);
+	waveData.loader.active=0;
+	
+	if(smpCnt<=0)
+		return;
+	
+	for(i=0;i<smpCnt;++i)
+	{
+		d=data[i*chanCnt+chanOffset]; // we want only one channel
+		d=(d*(INT16_MAX-WTOSC_SAMPLES_GUARD_BAND))>>15;
+		d-=INT16_MIN;
+		data[i]=d;
+	}
+
+	// move to the very end (multichannel), then the resampler read position always stays ahead of the write position
+	memmove(&sd[WAVE_SLOT_SIZE-smpCnt],data,smpCnt*sizeof(uint16_t));
+	resample(&sd[WAVE_SLOT_SIZE-smpCnt],sd,smpCnt,WTOSC_SAMPLE_COUNT,rmSinc);
+
+	waveData.slots[slot].bankNum=currentPreset->steppedParameters[abx2bsp[abx]];
+	waveData.slots[slot].waveNum=currentPreset->steppedParameters[abx2wsp[abx]];
+	waveData.slots[slot].valid=1;
+
+	useWaveSlot(abx,slot);
+}
+
+static void updateWaveLoader(void)
+{
+	int32_t cnt,chanCnt;
+	int16_t * data;
+	
+	if(!waveData.loader.active)
+	{
+		for(abx_t abx=0;abx<abxCount;++abx)
+			if(waveData.loader.pending&(1<<abx))
+			{
+				startWaveLoad(abx);
+				break;
+			}
+		return;
+	}
+	
+	// read one slice, raw samples go at the end of the slot, so that resampling can be done in place
+	
+	chanCnt=waveData.slots[waveData.loader.slot].channelCount;
+	cnt=MIN(WAVE_LOADER_SLICE/chanCnt,waveData.loader.smpCnt-waveData.loader.smpPos);
+	data=(int16_t *)&waveData.sampleData[waveData.loader.slot][WAVE_SLOT_SIZE-(waveData.loader.smpCnt-waveData.loader.smpPos)*chanCnt];
+
+	if(cnt>0 && wave_reader_get_samples_int16(&waveData.loader.wr,cnt,data))
+	{
+		cancelWaveLoad();
+		return;
+	}
+	
+	waveData.loader.smpPos+=cnt;
+	
+	if(waveData.loader.smpPos>=waveData.loader.smpCnt)
+		finishWaveLoad();
+}
+
+void synth_refreshWaveforms(abx_t abx)
+{
+	int i,bankNum,waveNum,slot;
+	
+	slot=findLoadedWaveSlot(abx);
+
+	if(slot>=0)
+	{
+		// still in a slot, the oscillators only need to be pointed to it
+		++waveData.reuses;
+		waveData.loader.pending&=~(1<<abx);
+		if(waveData.loader.active && waveData.loader.abx==abx)
+			cancelWaveLoad();
 		
-		resample(data,waveData.sampleData[abx],smpCnt,WTOSC_SAMPLE_COUNT);
+		useWaveSlot(abx,slot);
+
+		currentPreset->steppedParameters[abx2bsp[abx]]=waveData.slots[slot].bankNum;
+		currentPreset->steppedParameters[abx2wsp[abx]]=waveData.slots[slot].waveNum;
+
+#ifdef DEBUG
+		rprintf(0,"wave reused, %d reuses %d loads\n",waveData.reuses,waveData.loads);
+#endif		
+		return;
 	}
 	
+	// queue for the background loader, unless it's already loading it
+	
+	if(waveData.loader.active && waveData.loader.abx==abx && !isWaveSlotFor(waveData.loader.slot,abx))
+		cancelWaveLoad();
+	
+	if(!waveData.loader.active || waveData.loader.abx!=abx)
+		waveData.loader.pending|=1<<abx;
+	
 	// also recompute bank/wave indexes
 
 	bankNum=0;
 	synth_refreshBankNames(1,0);
 	for(i=0;i<synth_getBankCount();++i)
-		if(!strcmp(currentPreset.oscBank[abx],waveData.bankNames[i]))
+		if(!strcmp(currentPreset->oscBank[abx],waveData.bankNames[i]))
 		{
 			bankNum=i;
 			break;
@@ -692,24 +1130,24 @@ void synth_refreshWaveforms(abx_t abx)
 	waveNum=0;
 	synth_refreshCurWaveNames(abx,1);
 	for(i=0;i<synth_getCurWaveCount();++i)
-		if(!strcmp(currentPreset.oscWave[abx],waveData.curWaveNames[i]))
+		if(!strcmp(currentPreset->oscWave[abx],waveData.curWaveNames[i]))
 		{
 			waveNum=i;
 			break;
 		}
 
-	currentPreset.steppedParameters[abx2bsp[abx]]=bankNum;
-	currentPreset.steppedParameters[abx2wsp[abx]]=waveNum;
-}	
+	currentPreset->steppedParameters[abx2bsp[abx]]=bankNum;
+	currentPreset->steppedParameters[abx2wsp[abx]]=waveNum;
+}
 
 void synth_updateAssignerPattern(void)
 {
-	if(currentPreset.steppedParameters[spUnison])
+	if(currentPreset->steppedParameters[spUnison])
 		assigner_latchPattern();
 	else
 		assigner_setPoly();
 
-	assigner_getPattern(currentPreset.voicePattern,NULL);
+	assigner_getPattern(currentPreset->voicePattern,NULL);
 }
 
 void synth_silenceSynth(void)
@@ -726,20 +1164,28 @@ void synth_silenceSynth(void)
 // Speed critical internal code
 ////////////////////////////////////////////////////////////////////////////////
 
-static inline void computeGlide(uint16_t * out, const uint16_t target, const uint16_t amount)
+static FORCEINLINE void computeGlide(uint32_t * out, const uint16_t target, const int8_t exponential)
 {
-	uint16_t diff;
+	int32_t diff,step;
+	
+	diff=((int32_t)target<<GLIDE_FRAC_SHIFT)-(int32_t)*out;
 	
-	if(*out<target)
+	if(exponential)
 	{
-		diff=target-*out;
-		*out+=MIN(amount,diff);
+		// one-pole, glide time doesn't depend on interval
+		step=((int64_t)diff*synth.partState.glideCoef)>>16;
 	}
-	else if(*out>target)
+	else
 	{
-		diff=*out-target;
-		*out-=MIN(amount,diff);
+		// constant rate
+		step=MIN(diff,(int32_t)synth.partState.glideIncrement);
+		step=MAX(step,-(int32_t)synth.partState.glideIncrement);
 	}
+	
+	if(!step || abs(diff)<(1<<GLIDE_FRAC_SHIFT))
+		*out=(uint32_t)target<<GLIDE_FRAC_SHIFT;
+	else
+		*out+=step;
 }
 
 static FORCEINLINE uint16_t adjustCV(cv_t cv, uint32_t value)
@@ -768,10 +1214,14 @@ static FORCEINLINE uint16_t adjustCV(cv_t cv, uint32_t value)
 
 FORCEINLINE void synth_refreshCV(int8_t voice, cv_t cv, uint32_t value, int8_t noDblBuf)
 {
-	static const uint8_t ampVoice2CV[SYNTH_VOICE_COUNT]={0,1,2,3,8,9};
-	static const uint8_t cutoffVoice2CV[SYNTH_VOICE_COUNT]={4,15,14,13,12,11};
+	static const uint8_t ampVoice2CV[DACSPI_BOARD_VOICE_COUNT]={0,1,2,3,8,9};
+	static const uint8_t cutoffVoice2CV[DACSPI_BOARD_VOICE_COUNT]={4,15,14,13,12,11};
 	uint16_t v,channel;
 	
+	// voices beyond the main board have no CV DAC
+	if(voice>=DACSPI_BOARD_VOICE_COUNT)
+		return;
+	
 	value=__USAT(value,16);
 	v=adjustCV(cv,value);
 
@@ -802,21 +1252,64 @@ FORCEINLINE void synth_refreshCV(int8_t voice, cv_t cv, uint32_t value, int8_t n
 	dacspi_setCVValue(channel,v,noDblBuf);
 }
 
+static FORCEINLINE void addVoiceLfo(int8_t v, int8_t l, int32_t * pitchAVal, int32_t * pitchBVal, int32_t * wmodAVal, int32_t * wmodBVal, int32_t * filterVal, int32_t * ampVal)
+{
+	int32_t val;
+	int16_t out=synth.voiceLfo[l][v].output;
+	uint8_t targets=currentPreset->steppedParameters[(l)?spLFO2Targets:spLFOTargets];
+	
+	val=scaleU16S16(currentPreset->continuousParameters[(l)?cpLFO2PitchAmt:cpLFOPitchAmt],out>>1);
+	if(targets&otA)
+		*pitchAVal+=val;
+	if(targets&otB)
+		*pitchBVal+=val;
+
+	val=scaleU16S16(currentPreset->continuousParameters[(l)?cpLFO2WModAmt:cpLFOWModAmt],out);
+	if(targets&otA)
+		*wmodAVal+=val;
+	if(targets&otB)
+		*wmodBVal+=val;
+	
+	*filterVal+=scaleU16S16(currentPreset->continuousParameters[(l)?cpLFO2FilAmt:cpLFOFilAmt],out);
+
+	val=scaleU16S16(currentPreset->continuousParameters[(l)?cpLFO2AmpAmt:cpLFOAmpAmt],out);
+	*ampVal+=scaleU16S16(currentPreset->continuousParameters[cpAmpLevel],val);
+}
+
 static FORCEINLINE void refreshVoice(int8_t v,int32_t wmodAEnvAmt,int32_t wmodBEnvAmt,int32_t filEnvAmt,int32_t pitchAVal,int32_t pitchBVal,int32_t wmodAVal,int32_t wmodBVal,int32_t filterVal,int32_t ampVal)
 {
 	int32_t vpa,vpb,vma,vmb,vf,vamp;
 
-	// envs
+	// per voice LFOs
+	
+	if(currentPreset->steppedParameters[spLFOPerVoice] || currentPreset->steppedParameters[spLFO2PerVoice])
+	{
+		if(currentPreset->steppedParameters[spLFOPerVoice])
+			addVoiceLfo(v,0,&pitchAVal,&pitchBVal,&wmodAVal,&wmodBVal,&filterVal,&ampVal);
+		if(currentPreset->steppedParameters[spLFO2PerVoice])
+			addVoiceLfo(v,1,&pitchAVal,&pitchBVal,&wmodAVal,&wmodBVal,&filterVal,&ampVal);
+
+		wmodAVal=__USAT(wmodAVal,16);
+		wmodBVal=__USAT(wmodBVal,16);
+		ampVal=__USAT(ampVal,16);
+	}
 
-	adsr_update(&synth.ampEnvs[v]);
-	adsr_update(&synth.filEnvs[v]);
-	adsr_update(&synth.wmodEnvs[v]);
+	// glide
+	
+	if(synth.partState.gliding)
+	{
+		int8_t exponential=currentPreset->steppedParameters[spGlideMode]==gmExponential;
+
+		computeGlide(&synth.oscANoteCV[v],synth.oscATargetCV[v],exponential);
+		computeGlide(&synth.oscBNoteCV[v],synth.oscBTargetCV[v],exponential);
+		computeGlide(&synth.filterNoteCV[v],synth.filterTargetCV[v],exponential);
+	}
 
 	// filter
 
 	vf=filterVal;
 	vf+=scaleU16S16(synth.filEnvs[v].output,filEnvAmt);
-	vf+=synth.filterNoteCV[v];
+	vf+=synth.filterNoteCV[v]>>GLIDE_FRAC_SHIFT;
 	synth_refreshCV(v,cvCutoff,vf,0);
 
 	// oscs
@@ -830,28 +1323,40 @@ static FORCEINLINE void refreshVoice(int8_t v,int32_t wmodAEnvAmt,int32_t wmodBE
 	vmb=__USAT(vmb,16);
 
 	vpa=pitchAVal;
-	if(currentPreset.steppedParameters[spAWModType]==wmFrequency)
+	if(currentPreset->steppedParameters[spAWModType]==wmFrequency)
 		vpa+=vma-HALF_RANGE;
 
 	vpb=pitchBVal;
-	if(currentPreset.steppedParameters[spBWModType]==wmFrequency)
+	if(currentPreset->steppedParameters[spBWModType]==wmFrequency)
 		vpb+=vmb-HALF_RANGE;
 
 	// osc A
 
-	vpa+=synth.oscANoteCV[v];
+	vpa+=synth.oscANoteCV[v]>>GLIDE_FRAC_SHIFT;
 	vpa=__USAT(vpa,16);
-	wtosc_setParameters(&synth.osc[v][0],vpa,currentPreset.steppedParameters[spAWModType],vma);
+	wtosc_setParameters(&synth.osc[v][0],vpa,currentPreset->steppedParameters[spAWModType],vma);
 
 	// osc B
 
-	vpb+=synth.oscBNoteCV[v];
+	vpb+=synth.oscBNoteCV[v]>>GLIDE_FRAC_SHIFT;
 	vpb=__USAT(vpb,16);
-	wtosc_setParameters(&synth.osc[v][1],vpb,currentPreset.steppedParameters[spBWModType],vmb);
+	wtosc_setParameters(&synth.osc[v][1],vpb,currentPreset->steppedParameters[spBWModType],vmb);
 
 	// amplifier
 	
-	vamp=scaleU16U16(synth.ampEnvs[v].output,ampVal);
+	if(currentPreset->steppedParameters[spAmpEnvDigital])
+	{
+		// envelope applied at sample rate by the oscs, VCA only opened while the envelope runs
+		wtosc_setAmplitude(&synth.osc[v][0],synth.ampEnvs[v].output);
+		wtosc_setAmplitude(&synth.osc[v][1],synth.ampEnvs[v].output);
+		vamp=(adsr_getStage(&synth.ampEnvs[v])!=sWait)?ampVal:0;
+	}
+	else
+	{
+		wtosc_setAmplitude(&synth.osc[v][0],UINT16_MAX);
+		wtosc_setAmplitude(&synth.osc[v][1],UINT16_MAX);
+		vamp=scaleU16U16(synth.ampEnvs[v].output,ampVal);
+	}
 	synth_refreshCV(v,cvAmp,vamp,0);
 }
 
@@ -911,17 +1416,28 @@ void synth_init(void)
 
 	lfo_init(&synth.lfo[0]);
 	lfo_init(&synth.lfo[1]);
+	for(i=0;i<SYNTH_VOICE_COUNT;++i)
+	{
+		lfo_init(&synth.voiceLfo[0][i]);
+		lfo_init(&synth.voiceLfo[1][i]);
+	}
 
 	// rest the synth on scale middle (prevents analog glitches)
 	for(i=0;i<SYNTH_VOICE_COUNT;++i)
 	{
-		synth.oscANoteCV[i]=synth.oscATargetCV[i]=tuner_computeCVFromNote(i,MIDDLE_C_NOTE,0,cvAPitch);
-		synth.oscBNoteCV[i]=synth.oscBTargetCV[i]=tuner_computeCVFromNote(i,MIDDLE_C_NOTE,0,cvBPitch);
-		synth.filterNoteCV[i]=synth.filterTargetCV[i]=tuner_computeCVFromNote(i,MIDDLE_C_NOTE,0,cvCutoff);
+		synth.oscATargetCV[i]=tuner_computeCVFromNote(i,MIDDLE_C_NOTE,0,cvAPitch);
+		synth.oscBTargetCV[i]=tuner_computeCVFromNote(i,MIDDLE_C_NOTE,0,cvBPitch);
+		synth.filterTargetCV[i]=tuner_computeCVFromNote(i,MIDDLE_C_NOTE,0,cvCutoff);
+		synth.oscANoteCV[i]=(uint32_t)synth.oscATargetCV[i]<<GLIDE_FRAC_SHIFT;
+		synth.oscBNoteCV[i]=(uint32_t)synth.oscBTargetCV[i]<<GLIDE_FRAC_SHIFT;
+		synth.filterNoteCV[i]=(uint32_t)synth.filterTargetCV[i]<<GLIDE_FRAC_SHIFT;
 	}
 	
 	// load settings from storage & load static stuff
 
+	for(abx_t abx=0;abx<abxCount;++abx)
+		waveData.abxSlot[abx]=abx;
+
 	settings_load();
 	synth_refreshBankNames(1,1);
 
@@ -944,18 +1460,26 @@ void synth_update(void)
 	putc_serial0('.');	
 #else
 	static int32_t frc=0,prevTick=0;
+	uint32_t irqPeak;
+	uint16_t irqLoad;
 	++frc;
 	if(currentTick-prevTick>=TICKER_HZ)
 	{
-		rprintf(0,"%d u/s\n",frc);
+		irqLoad=dacspi_getIRQLoad(&irqPeak);
+		rprintf(0,"%d u/s, %d voices, %d voice lfos, irq load %d.%d%% peak %d cycles\n",frc,SYNTH_VOICE_COUNT,
+				(currentPreset->steppedParameters[spLFOPerVoice]+currentPreset->steppedParameters[spLFO2PerVoice])*SYNTH_VOICE_COUNT,
+				irqLoad/10,irqLoad%10,irqPeak);
 		frc=0;
 		prevTick+=TICKER_HZ;
 	}
 #endif
 
 	scan_update();
+	updateWaveLoader();
 	ui_update();
 	midi_update();
+	settings_update();
+	preset_prefetch();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -980,23 +1504,13 @@ void synth_tickTimerEvent(uint8_t phase)
 			clock_update();
 			break;
 		case 2:
-			// glide
-			for(int8_t v=0;v<SYNTH_VOICE_COUNT;++v)
-			{
-				int16_t amt=synth.partState.glideAmount;
-
-				if(synth.partState.gliding)
-				{
-					computeGlide(&synth.oscANoteCV[v],synth.oscATargetCV[v],amt);
-					computeGlide(&synth.oscBNoteCV[v],synth.oscBTargetCV[v],amt);
-					computeGlide(&synth.filterNoteCV[v],synth.filterTargetCV[v],amt);
-				}
-			}
+			// glide is done at CV update rate, in refreshVoice()
 			break;
 		case 3:
 			refreshLfoSettings();
-			synth.partState.syncModeMaster=currentPreset.steppedParameters[spOscSync]?osmMaster:osmNone;
-			synth.partState.syncModeSlave=currentPreset.steppedParameters[spOscSync]?osmSlave:osmNone;
+			syncLfosToClock();
+			synth.partState.syncModeMaster=currentPreset->steppedParameters[spOscSync]?osmMaster:osmNone;
+			synth.partState.syncModeSlave=currentPreset->steppedParameters[spOscSync]?osmSlave:osmNone;
 			// 500hz tick counter
 			++currentTick;
 			break;
@@ -1010,17 +1524,18 @@ void synth_updateCVsEvent(void)
 {
 	int32_t val,pitchAVal,pitchBVal,wmodAVal,wmodBVal,filterVal,ampVal,wmodAEnvAmt,wmodBEnvAmt,filEnvAmt;
 	int32_t resoFactor=0, resVal=0;
+	int16_t lfo1Out,lfo2Out;
 	
 	// global CVs update
 
 	auto uint32_t getResonanceCompensatedCV(continuousParameter_t cp, cv_t cv)
 	{
-		return scaleU16U16(currentPreset.continuousParameters[cp],(getStaticCV(cv)-INT16_MIN))*resoFactor/256;
+		return scaleU16U16(currentPreset->continuousParameters[cp],(getStaticCV(cv)-INT16_MIN))*resoFactor/256;
 	}
 		
-	resVal=currentPreset.continuousParameters[cpResonance];
-	resVal+=scaleU16S16(currentPreset.continuousParameters[cpLFOResAmt],synth.lfo[0].output);
-	resVal+=scaleU16S16(currentPreset.continuousParameters[cpLFO2ResAmt],synth.lfo[1].output);
+	resVal=currentPreset->continuousParameters[cpResonance];
+	resVal+=scaleU16S16(currentPreset->continuousParameters[cpLFOResAmt],synth.lfo[0].output);
+	resVal+=scaleU16S16(currentPreset->continuousParameters[cpLFO2ResAmt],synth.lfo[1].output);
 	resVal=__USAT(resVal,16);
 
 		// compensate resonance lowering volume by abjusting pre filter mixer level
@@ -1035,6 +1550,22 @@ void synth_updateCVsEvent(void)
 		
 	lfo_update(&synth.lfo[0]);
 	lfo_update(&synth.lfo[1]);
+	
+	if(currentPreset->steppedParameters[spLFOPerVoice])
+		lfo_updateBank(synth.voiceLfo[0],SYNTH_VOICE_COUNT);
+	if(currentPreset->steppedParameters[spLFO2PerVoice])
+		lfo_updateBank(synth.voiceLfo[1],SYNTH_VOICE_COUNT);
+	
+	// global LFOs outputs, per voice ones are added in refreshVoice()
+	
+	lfo1Out=currentPreset->steppedParameters[spLFOPerVoice]?0:synth.lfo[0].output;
+	lfo2Out=currentPreset->steppedParameters[spLFO2PerVoice]?0:synth.lfo[1].output;
+
+	// envs (idle and sustaining ones are skipped)
+	
+	adsr_updateBank(synth.ampEnvs,SYNTH_VOICE_COUNT);
+	adsr_updateBank(synth.filEnvs,SYNTH_VOICE_COUNT);
+	adsr_updateBank(synth.wmodEnvs,SYNTH_VOICE_COUNT);
 		
 	// global computations
 	
@@ -1042,60 +1573,60 @@ void synth_updateCVsEvent(void)
 
 	pitchAVal=pitchBVal=0;
 
-	val=scaleU16S16(currentPreset.continuousParameters[cpLFOPitchAmt],synth.lfo[0].output>>1);
-	if(currentPreset.steppedParameters[spLFOTargets]&otA)
+	val=scaleU16S16(currentPreset->continuousParameters[cpLFOPitchAmt],lfo1Out>>1);
+	if(currentPreset->steppedParameters[spLFOTargets]&otA)
 		pitchAVal+=val;
-	if(currentPreset.steppedParameters[spLFOTargets]&otB)
+	if(currentPreset->steppedParameters[spLFOTargets]&otB)
 		pitchBVal+=val;
 
-	val=scaleU16S16(currentPreset.continuousParameters[cpLFO2PitchAmt],synth.lfo[1].output>>1);
-	if(currentPreset.steppedParameters[spLFO2Targets]&otA)
+	val=scaleU16S16(currentPreset->continuousParameters[cpLFO2PitchAmt],lfo2Out>>1);
+	if(currentPreset->steppedParameters[spLFO2Targets]&otA)
 		pitchAVal+=val;
-	if(currentPreset.steppedParameters[spLFO2Targets]&otB)
+	if(currentPreset->steppedParameters[spLFO2Targets]&otB)
 		pitchBVal+=val;
 
 		// filter
 
-	filterVal=scaleU16S16(currentPreset.continuousParameters[cpLFOFilAmt],synth.lfo[0].output);
-	filterVal+=scaleU16S16(currentPreset.continuousParameters[cpLFO2FilAmt],synth.lfo[1].output);
+	filterVal=scaleU16S16(currentPreset->continuousParameters[cpLFOFilAmt],lfo1Out);
+	filterVal+=scaleU16S16(currentPreset->continuousParameters[cpLFO2FilAmt],lfo2Out);
 	
 		// amplifier
 
 	ampVal=UINT16_MAX;
 
-	ampVal-=scaleU16U16(currentPreset.continuousParameters[cpLFOAmpAmt],synth.lfo[0].levelCV>>1);
-	ampVal+=scaleU16S16(currentPreset.continuousParameters[cpLFOAmpAmt],synth.lfo[0].output);
+	ampVal-=scaleU16U16(currentPreset->continuousParameters[cpLFOAmpAmt],synth.lfo[0].levelCV>>1);
+	ampVal+=scaleU16S16(currentPreset->continuousParameters[cpLFOAmpAmt],lfo1Out);
 
-	ampVal-=scaleU16U16(currentPreset.continuousParameters[cpLFO2AmpAmt],synth.lfo[1].levelCV>>1);
-	ampVal+=scaleU16S16(currentPreset.continuousParameters[cpLFO2AmpAmt],synth.lfo[1].output);
+	ampVal-=scaleU16U16(currentPreset->continuousParameters[cpLFO2AmpAmt],synth.lfo[1].levelCV>>1);
+	ampVal+=scaleU16S16(currentPreset->continuousParameters[cpLFO2AmpAmt],lfo2Out);
 
-	ampVal=scaleU16U16(ampVal,currentPreset.continuousParameters[cpAmpLevel]);
+	ampVal=scaleU16U16(ampVal,currentPreset->continuousParameters[cpAmpLevel]);
 
 		// misc
 
-	filEnvAmt=currentPreset.continuousParameters[cpFilEnvAmt];
+	filEnvAmt=currentPreset->continuousParameters[cpFilEnvAmt];
 	filEnvAmt+=INT16_MIN;
 
-	wmodAVal=currentPreset.continuousParameters[cpABaseWMod];
-	if(currentPreset.steppedParameters[spAWModType]==wmFrequency)
+	wmodAVal=currentPreset->continuousParameters[cpABaseWMod];
+	if(currentPreset->steppedParameters[spAWModType]==wmFrequency)
 		wmodAVal=((wmodAVal-HALF_RANGE)>>1)+HALF_RANGE; // half scale for freq mod
-	if(currentPreset.steppedParameters[spLFOTargets]&otA)
-		wmodAVal+=scaleU16S16(currentPreset.continuousParameters[cpLFOWModAmt],synth.lfo[0].output);
-	if(currentPreset.steppedParameters[spLFO2Targets]&otA)
-		wmodAVal+=scaleU16S16(currentPreset.continuousParameters[cpLFO2WModAmt],synth.lfo[1].output);
+	if(currentPreset->steppedParameters[spLFOTargets]&otA)
+		wmodAVal+=scaleU16S16(currentPreset->continuousParameters[cpLFOWModAmt],lfo1Out);
+	if(currentPreset->steppedParameters[spLFO2Targets]&otA)
+		wmodAVal+=scaleU16S16(currentPreset->continuousParameters[cpLFO2WModAmt],lfo2Out);
 	wmodAVal+=getStaticCV(cvWaveMod);
 
-	wmodBVal=currentPreset.continuousParameters[cpBBaseWMod];
-	if(currentPreset.steppedParameters[spBWModType]==wmFrequency)
+	wmodBVal=currentPreset->continuousParameters[cpBBaseWMod];
+	if(currentPreset->steppedParameters[spBWModType]==wmFrequency)
 		wmodBVal=((wmodBVal-HALF_RANGE)>>1)+HALF_RANGE; // half scale for freq mod
-	if(currentPreset.steppedParameters[spLFOTargets]&otB)
-		wmodBVal+=scaleU16S16(currentPreset.continuousParameters[cpLFOWModAmt],synth.lfo[0].output);
-	if(currentPreset.steppedParameters[spLFO2Targets]&otB)
-		wmodBVal+=scaleU16S16(currentPreset.continuousParameters[cpLFO2WModAmt],synth.lfo[1].output);
+	if(currentPreset->steppedParameters[spLFOTargets]&otB)
+		wmodBVal+=scaleU16S16(currentPreset->continuousParameters[cpLFOWModAmt],lfo1Out);
+	if(currentPreset->steppedParameters[spLFO2Targets]&otB)
+		wmodBVal+=scaleU16S16(currentPreset->continuousParameters[cpLFO2WModAmt],lfo2Out);
 	wmodBVal+=getStaticCV(cvWaveMod);
 
-	wmodAEnvAmt=currentPreset.continuousParameters[cpWModAEnv];
-	wmodBEnvAmt=currentPreset.continuousParameters[cpWModBEnv];
+	wmodAEnvAmt=currentPreset->continuousParameters[cpWModAEnv];
+	wmodBEnvAmt=currentPreset->continuousParameters[cpWModBEnv];
 	wmodAEnvAmt+=INT16_MIN;
 	wmodBEnvAmt+=INT16_MIN;
 
@@ -1114,30 +1645,15 @@ void synth_updateCVsEvent(void)
 		refreshVoice(v,wmodAEnvAmt,wmodBEnvAmt,filEnvAmt,pitchAVal,pitchBVal,wmodAVal,wmodBVal,filterVal,ampVal);
 }
 
-#define PROC_UPDATE_OSCS_VOICE(v) \
-FORCEINLINE static void updateOscsVoice##v(int32_t start, int32_t end) \
-{ \
-	wtosc_update(&synth.osc[v][0],start,end,synth.partState.syncModeMaster,synth.partState.syncPositions); \
-	wtosc_update(&synth.osc[v][1],start,end,synth.partState.syncModeSlave,synth.partState.syncPositions); \
-}
-
-PROC_UPDATE_OSCS_VOICE(0);
-PROC_UPDATE_OSCS_VOICE(1);
-PROC_UPDATE_OSCS_VOICE(2);
-PROC_UPDATE_OSCS_VOICE(3);
-PROC_UPDATE_OSCS_VOICE(4);
-PROC_UPDATE_OSCS_VOICE(5);
-
 void synth_updateOscsEvent(int32_t start, int32_t count)
 {
 	int32_t end=start+count-1;
 
-	updateOscsVoice0(start,end);
-	updateOscsVoice1(start,end);
-	updateOscsVoice2(start,end);
-	updateOscsVoice3(start,end);
-	updateOscsVoice4(start,end);
-	updateOscsVoice5(start,end);
+	for(int8_t v=0;v<SYNTH_VOICE_COUNT;++v)
+	{
+		wtosc_update(&synth.osc[v][0],start,end,synth.partState.syncModeMaster,synth.partState.syncPositions);
+		wtosc_update(&synth.osc[v][1],start,end,synth.partState.syncModeSlave,synth.partState.syncPositions);
+	}
 }
 
 void synth_assignerEvent(uint8_t note, int8_t gate, int8_t voice, uint16_t velocity, uint8_t flags)
@@ -1165,18 +1681,24 @@ void synth_assignerEvent(uint8_t note, int8_t gate, int8_t voice, uint16_t veloc
 	if(gate)
 	{
 		// handle velocity
-		velAmt=currentPreset.continuousParameters[cpWModVelocity];
+		velAmt=currentPreset->continuousParameters[cpWModVelocity];
 		adsr_setCVs(&synth.wmodEnvs[voice],0,0,0,0,(UINT16_MAX-velAmt)+scaleU16U16(velocity,velAmt),0x10);
-		velAmt=currentPreset.continuousParameters[cpFilVelocity];
+		velAmt=currentPreset->continuousParameters[cpFilVelocity];
 		adsr_setCVs(&synth.filEnvs[voice],0,0,0,0,(UINT16_MAX-velAmt)+scaleU16U16(velocity,velAmt),0x10);
-		velAmt=currentPreset.continuousParameters[cpAmpVelocity];
+		velAmt=currentPreset->continuousParameters[cpAmpVelocity];
 		adsr_setCVs(&synth.ampEnvs[voice],0,0,0,0,(UINT16_MAX-velAmt)+scaleU16U16(velocity,velAmt),0x10);
 		
 		// handle LFOs trigger
-		if(currentPreset.steppedParameters[spLFOTrig])
+		if(currentPreset->steppedParameters[spLFOTrig])
+		{
 			lfo_reset(&synth.lfo[0]);
-		if(currentPreset.steppedParameters[spLFO2Trig])
+			lfo_reset(&synth.voiceLfo[0][voice]);
+		}
+		if(currentPreset->steppedParameters[spLFO2Trig])
+		{
 			lfo_reset(&synth.lfo[1]);
+			lfo_reset(&synth.voiceLfo[1][voice]);
+		}
 	}
 }
 
@@ -1209,9 +1731,9 @@ void synth_wheelEvent(int16_t bend, uint16_t modulation, uint8_t mask)
 
 	if(mask&1)
 	{
-		uint8_t range=br[currentPreset.steppedParameters[spBenderRange]];
+		uint8_t range=br[currentPreset->steppedParameters[spBenderRange]];
 		
-		switch(currentPreset.steppedParameters[spBenderTarget])
+		switch(currentPreset->steppedParameters[spBenderTarget])
 		{
 			case modPitch:
 				bend=scaleU16S16(tuner_computeCVFromNote(0,range*2,0,cvAPitch)-tuner_computeCVFromNote(0,0,0,cvAPitch),bend);
@@ -1227,14 +1749,14 @@ void synth_wheelEvent(int16_t bend, uint16_t modulation, uint8_t mask)
 
 		synth.partState.benderAmount=bend;
 
-		if(currentPreset.steppedParameters[spBenderTarget]==modPitch ||
-				currentPreset.steppedParameters[spBenderTarget]==modFilter)
+		if(currentPreset->steppedParameters[spBenderTarget]==modPitch ||
+				currentPreset->steppedParameters[spBenderTarget]==modFilter)
 			refreshTunedCVs();
 	}
 	
 	if(mask&2)
 	{
-		synth.partState.modwheelAmount=modulation>>mr[currentPreset.steppedParameters[spModwheelRange]];
+		synth.partState.modwheelAmount=modulation>>mr[currentPreset->steppedParameters[spModwheelRange]];
 		refreshLfoSettings();
 	}
 }
@@ -1247,9 +1769,9 @@ void synth_pressureEvent(uint16_t pressure)
 	rprintf(0,"pressure %d\n",pressure);
 #endif
 	
-	synth.partState.pressureAmount=pressure>>pr[currentPreset.steppedParameters[spPressureRange]];
+	synth.partState.pressureAmount=pressure>>pr[currentPreset->steppedParameters[spPressureRange]];
 
-	switch(currentPreset.steppedParameters[spPressureTarget])
+	switch(currentPreset->steppedParameters[spPressureTarget])
 	{
 		case modPitch:
 			synth.partState.pressureAmount>>=2; // less modulation for pitch
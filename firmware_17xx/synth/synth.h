@@ -5,7 +5,9 @@
 #include "midi.h"
 #include "utils.h"
 
-#define SYNTH_VOICE_COUNT 6
+#ifndef SYNTH_VOICE_COUNT
+#define SYNTH_VOICE_COUNT 6 // can be overridden at build time (make VOICE_COUNT=n)
+#endif
 //#define SYNTH_MASTER_CLOCK SystemCoreClock
 #define SYNTH_MASTER_CLOCK 120000000
 
@@ -71,6 +73,7 @@ void synth_update(void);
 // synth.c internal api
 void synth_refreshFullState(int8_t refreshWaveforms);
 int8_t synth_refreshBankNames(int8_t sort, int8_t force);
+void synth_invalidateWaveIndexes(void);
 void synth_refreshCurWaveNames(abx_t abx, int8_t sort);
 void synth_refreshWaveforms(abx_t abx);
 int synth_getBankCount(void);
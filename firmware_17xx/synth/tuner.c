@@ -9,7 +9,8 @@
 #include "scan.h"
 #include "dacspi.h"
 
-#define TUNER_SR_BUF_DIV 4 // divide the sample rate by this and you get the buffer length, this is also the lowest theoretical tunable frequency
+#define TUNER_SR_BUF_DIV 4 // divide the sample rate by this and you get the measured sample count, this is also the lowest theoretical tunable frequency
+#define TUNER_EXTENTS_DIV 40 // same for the waveform extents measurement, 25ms
 
 #define TUNER_MIDDLE_C_HERTZ 261.63
 #define TUNER_LOWEST_HERTZ (TUNER_MIDDLE_C_HERTZ/16)
@@ -19,6 +20,18 @@
 #define TUNER_FIL_NTH_C_LO 5
 #define TUNER_FIL_NTH_C_HI 7
 
+#define TUNER_NOTE_COUNT 256 // whole uint8_t note range
+#define TUNER_NOTE_OCTAVES (TUNER_NOTE_COUNT/12+2) // +1 for the octave above the last note
+
+// per voice cutoff CVs for each C, upper octaves already extrapolated, tuning is linear in between
+// (one CV per note would be 3KB of RAM at 6 voices)
+static EXT_RAM uint16_t cutoffOctaveCV[TUNER_CV_COUNT][TUNER_NOTE_OCTAVES];
+
+static const uint16_t semiToneFrac[12]= // (semitone<<16)/12
+{
+	0,5461,10922,16384,21845,27306,32768,38229,43690,49152,54613,60074
+};
+
 static uint16_t extrapolateUpperOctavesTunes(int8_t voice, int8_t oct)
 {
 	uint32_t v;
@@ -40,27 +53,11 @@ static LOWERCODESIZE void prepareSynth(void)
 
 static NOINLINE LOWERCODESIZE uint32_t measureThruZeroCount(void)
 {
-	uint32_t tzCnt=0;
-	uint16_t prev;
-		
-#define MAP_BUF_LEN (SCAN_MASTERMIX_SAMPLERATE/TUNER_SR_BUF_DIV)
-#define MAP_BUF_HALF_RANGE (-INT16_MIN)
-	uint16_t buf[MAP_BUF_LEN];
-
-	scan_sampleMasterMix(MAP_BUF_LEN,buf);
-
-	prev=buf[0];
-	for(uint16_t pos=0;pos<MAP_BUF_LEN;++pos)
-	{
-		uint16_t sample=buf[pos];
-			
-		if ((prev<=MAP_BUF_HALF_RANGE&&sample>MAP_BUF_HALF_RANGE) || (prev>=MAP_BUF_HALF_RANGE&&sample<MAP_BUF_HALF_RANGE))
-			++tzCnt;
-
-		prev=sample;
-	}
+	// the extents pass only has to see a few periods around the target frequencies, a wrong middle below them
+	// gives a lower count, which is the right binary search decision anyway
+	// counting on the fly avoids a 5KB sample buffer, the largest stack user
 	
-	return tzCnt;
+	return scan_countMasterMixCrossings(SCAN_MASTERMIX_SAMPLERATE/TUNER_EXTENTS_DIV,SCAN_MASTERMIX_SAMPLERATE/TUNER_SR_BUF_DIV);
 }
 
 static LOWERCODESIZE void tuneOffset(int8_t voice,uint8_t nthC)
@@ -129,12 +126,37 @@ static LOWERCODESIZE void tuneFilter(int8_t voice)
 	synth_refreshCV(voice,cvAmp,0,1);
 }
 
-NOINLINE uint16_t tuner_computeCVFromNote(int8_t voice, uint8_t note, uint8_t nextInterp, cv_t cv)
+static FORCEINLINE uint16_t computeCutoffCV(int8_t voice, uint16_t note)
 {
-	int8_t loOct,hiOct;
-	uint16_t value,loVal,hiVal;
+	uint16_t oct,value,loVal,hiVal;
 	uint32_t semiTone;
 	
+	oct=note/12; // constant divide, compiles to a multiply
+	
+	loVal=cutoffOctaveCV[voice][oct];
+	hiVal=cutoffOctaveCV[voice][oct+1];
+	semiTone=semiToneFrac[note-oct*12];
+
+	value=loVal;
+	value+=(semiTone*(hiVal-loVal))>>16;
+
+	return value;
+}
+
+static LOWERCODESIZE void updateCutoffLookup(void)
+{
+	int8_t v,o;
+	
+	for(v=0;v<TUNER_CV_COUNT;++v)
+		for(o=0;o<TUNER_NOTE_OCTAVES;++o)
+			cutoffOctaveCV[v][o]=(o<TUNER_OCTAVE_COUNT)?settings.tunes[o][v]:extrapolateUpperOctavesTunes(v,o);
+}
+
+uint16_t tuner_computeCVFromNote(int8_t voice, uint8_t note, uint8_t nextInterp, cv_t cv)
+{
+	uint16_t value;
+	int32_t diff;
+	
 	if(cv==cvAPitch || cv==cvBPitch)
 	{
 		// perfect tuning for oscillators
@@ -142,28 +164,24 @@ NOINLINE uint16_t tuner_computeCVFromNote(int8_t voice, uint8_t note, uint8_t ne
 	}
 	else
 	{
-		loOct=note/12;
-		hiOct=loOct+1;
-
-		if(loOct<TUNER_OCTAVE_COUNT)
-			loVal=settings.tunes[loOct][voice];
-		else
-			loVal=extrapolateUpperOctavesTunes(voice,loOct);
-
-		if(hiOct<TUNER_OCTAVE_COUNT)
-			hiVal=settings.tunes[hiOct][voice];
-		else
-			hiVal=extrapolateUpperOctavesTunes(voice,hiOct);
-
-		semiTone=(((uint32_t)(note%12)<<16)+((uint16_t)nextInterp<<8))/12;
-
-		value=loVal;
-		value+=(semiTone*(hiVal-loVal))>>16;
+		// tuning is linear between semitones
+		value=computeCutoffCV(voice,note);
+		diff=(int32_t)computeCutoffCV(voice,note+1)-value;
+		value+=(diff*nextInterp)>>8;
 	}
 
 	return value;
 }
 
+LOWERCODESIZE void tuner_tunesChanged(void)
+{
+	updateCutoffLookup();
+	
+#ifdef DEBUG
+	rprintf(0,"cutoff lookup %d bytes\n",sizeof(cutoffOctaveCV));
+#endif
+}
+
 LOWERCODESIZE void tuner_init(void)
 {
 	int8_t cv,oct;
@@ -175,6 +193,8 @@ LOWERCODESIZE void tuner_init(void)
 		{
 			settings.tunes[oct][cv]=TUNER_FIL_INIT_OFFSET+oct*TUNER_FIL_INIT_SCALE;
 		}
+	
+	tuner_tunesChanged();
 }
 
 LOWERCODESIZE void tuner_tuneSynth(void)
@@ -212,5 +232,7 @@ LOWERCODESIZE void tuner_tuneSynth(void)
 		for(v=0;v<SYNTH_VOICE_COUNT;++v)
 			synth_refreshCV(v,cvAmp,0,1);
 		scan_setMode(0);
+		
+		tuner_tunesChanged();
 	}
 }
\ No newline at end of file
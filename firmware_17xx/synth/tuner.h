@@ -9,7 +9,8 @@
 uint16_t tuner_computeCVFromNote(int8_t voice, uint8_t note, uint8_t nextInterp, cv_t cv);
 
 void tuner_init(void);
-void tuner_tuneSynth(void);
+void tuner_tuneSynth(void);
+void tuner_tunesChanged(void); // call after settings.tunes was modified
 
 #endif	/* TUNER_H */
 
@@ -30,7 +30,6 @@ static struct
 	enum uiPage_e activePage;
 	int8_t activeSource;
 	int8_t sourceChanges,prevSourceChanges;
-	uint32_t settingsModifiedTimeout;
 	uint32_t activeSourceTimeout;
 	uint32_t slowUpdateTimeout;
 	int16_t slowUpdateTimeoutNumber;
@@ -53,6 +52,8 @@ static struct
 	int8_t isTransposing;
 	int32_t transpose;
 	
+	int8_t visualEnv[SYNTH_VOICE_COUNT];
+	
 	struct hd44780_data lcd1, lcd2;
 } ui;
 
@@ -254,11 +255,10 @@ static void drawVisualEnv(int lcd, int8_t voicePair, int8_t force)
 {
 	int8_t i,ve,ve2;
 	uint32_t veb;
-	static int8_t old_ve[SYNTH_VOICE_COUNT]={INT8_MIN,INT8_MIN,INT8_MIN,INT8_MIN,INT8_MIN,INT8_MIN};
 	
 	ve=synth_getVisualEnvelope(voicePair)>>11;
 	ve2=synth_getVisualEnvelope(voicePair+1)>>11;
-	if(ve!=old_ve[voicePair] || ve2!=old_ve[voicePair+1] || force)
+	if(ve!=ui.visualEnv[voicePair] || ve2!=ui.visualEnv[voicePair+1] || force)
 	{
 		veb=0;
 		for(i=0;i<32;++i)
@@ -288,8 +288,8 @@ static void drawVisualEnv(int lcd, int8_t voicePair, int8_t force)
 		sendChar(lcd, ((veb>> 4) & 0xf) | 0b10000);
 		sendChar(lcd, ((veb    ) & 0xf) | 0b00000);
 		
-		old_ve[voicePair]=ve;
-		old_ve[voicePair+1]=ve2;
+		ui.visualEnv[voicePair]=ve;
+		ui.visualEnv[voicePair+1]=ve2;
 	}
 }
 
@@ -489,13 +489,13 @@ static char * getDisplayValue(int8_t source, int32_t * valueOut)
 	switch(prm->type)
 	{
 	case ptCont:
-		value=currentPreset.continuousParameters[prm->number];
+		value=currentPreset->continuousParameters[prm->number];
 
 		switch(prm->number)
 		{
 		case cpAFreq:
 		case cpBFreq:
-			switch(currentPreset.steppedParameters[spChromaticPitch])
+			switch(currentPreset->steppedParameters[spChromaticPitch])
 			{
 				case 2: // octaves
 					tmp=value>>10;
@@ -526,7 +526,7 @@ static char * getDisplayValue(int8_t source, int32_t * valueOut)
 	case ptCust:
 		if(prm->type==ptStep)
 		{
-			value=currentPreset.steppedParameters[prm->number];
+			value=currentPreset->steppedParameters[prm->number];
 		}
 		else
 		{
@@ -589,13 +589,13 @@ static char * getDisplayValue(int8_t source, int32_t * valueOut)
 					value=settings.seqArpClock;
 				break;
 			case cnAXoSw:
-				value=currentPreset.steppedParameters[spAXOvrBank_Unsaved]*100;
-				value+=currentPreset.steppedParameters[spAXOvrWave_Unsaved]%100;
+				value=currentPreset->steppedParameters[spAXOvrBank_Unsaved]*100;
+				value+=currentPreset->steppedParameters[spAXOvrWave_Unsaved]%100;
 				srprintf(dv,"%04d",value);
 				break;
 			case cnBXoSw:
-				value=currentPreset.steppedParameters[spBXOvrBank_Unsaved]*100;
-				value+=currentPreset.steppedParameters[spBXOvrWave_Unsaved]%100;
+				value=currentPreset->steppedParameters[spBXOvrBank_Unsaved]*100;
+				value+=currentPreset->steppedParameters[spBXOvrWave_Unsaved]%100;
 				srprintf(dv,"%04d",value);
 				break;
 			case cnLPrv:
@@ -625,13 +625,13 @@ static char * getDisplayValue(int8_t source, int32_t * valueOut)
 				value=settings.lcdContrast;
 				break;
 			case cnWEnT:
-				value=currentPreset.steppedParameters[spWModEnvLin]*2+currentPreset.steppedParameters[spWModEnvSlow];
+				value=currentPreset->steppedParameters[spWModEnvLin]*2+currentPreset->steppedParameters[spWModEnvSlow];
 				break;
 			case cnFEnT:
-				value=currentPreset.steppedParameters[spFilEnvLin]*2+currentPreset.steppedParameters[spFilEnvSlow];
+				value=currentPreset->steppedParameters[spFilEnvLin]*2+currentPreset->steppedParameters[spFilEnvSlow];
 				break;
 			case cnAEnT:
-				value=currentPreset.steppedParameters[spAmpEnvLin]*2+currentPreset.steppedParameters[spAmpEnvSlow];
+				value=currentPreset->steppedParameters[spAmpEnvLin]*2+currentPreset->steppedParameters[spAmpEnvSlow];
 				break;
 			}
 		}
@@ -663,7 +663,7 @@ static char * getDisplayFulltext(int8_t source)
 	
 	if(prm->type==ptCont)
 	{
-		int32_t v=currentPreset.continuousParameters[prm->number];
+		int32_t v=currentPreset->continuousParameters[prm->number];
 		
 		// scale
 		v=(v*LCD_WIDTH)/UINT16_MAX;
@@ -695,13 +695,13 @@ static char * getDisplayFulltext(int8_t source)
 			(prm->number==spABank_Unsaved || prm->number==spBBank_Unsaved ||
 			prm->number==spAXOvrBank_Unsaved || prm->number==spBXOvrBank_Unsaved))
 	{
-		strcpy(dv,currentPreset.oscBank[sp2abx[prm->number]]);
+		strcpy(dv,currentPreset->oscBank[sp2abx[prm->number]]);
 	}
 	else if (prm->type==ptStep &&
 			(prm->number==spAWave_Unsaved || prm->number==spBWave_Unsaved ||
 			prm->number==spAXOvrWave_Unsaved || prm->number==spBXOvrWave_Unsaved))
 	{
-		strcpy(dv,currentPreset.oscWave[sp2abx[prm->number]]);
+		strcpy(dv,currentPreset->oscWave[sp2abx[prm->number]]);
 	}
 	else if (prm->type==ptCust &&
 			(prm->number==cnLoad || prm->number==cnLNxt || prm->number==cnLPrv || prm->number==cnLBas))
@@ -729,7 +729,8 @@ static char * getDisplayFulltext(int8_t source)
 
 		selectedIdx=0;
 		valCount=0;
-		while(valCount<UIP_MAX_VALUES && prm->values[valCount]!=NULL)
+		while(valCount<UIP_MAX_VALUES && prm->values[valCount]!=NULL &&
+				(prm->type!=ptStep || valCount<steppedParametersSteps[prm->number].param))
 		{
 			if(strcmp(selected,"") && !strcmp(selected,prm->values[valCount]))
 				selectedIdx=valCount;
@@ -762,13 +763,13 @@ static void handlePageChange(enum scanKeypadButton_e button)
 		ui.activePage=upOscs;
 		break;
 	case kb2: 
-		ui.activePage=upWMod;
+		ui.activePage=(ui.activePage==upWMod)?upEnvs:upWMod; // twice for envelopes delay/hold/curves
 		break;
 	case kb3: 
-		ui.activePage=upFil;
+		ui.activePage=(ui.activePage==upFil)?upEnvs:upFil;
 		break;
 	case kb4: 
-		ui.activePage=upAmp;
+		ui.activePage=(ui.activePage==upAmp)?upEnvs:upAmp;
 		break;
 	case kb5: 
 		ui.activePage=upLFO1;
@@ -843,7 +844,7 @@ static void handleKeypadInput(enum scanKeypadButton_e button)
 		{
 			// preset number
 			settings.presetNumber=ui.kpInputValue;
-			ui.settingsModifiedTimeout=currentTick+ACTIVE_SOURCE_TIMEOUT;
+			settings_requestSave();
 		}
 	}
 }
@@ -1042,17 +1043,17 @@ static void scanEvent(int8_t source, uint16_t * forcedValue) // source: keypad (
 	{
 	case ptCont:
 		data=potSetting;
-		change=currentPreset.continuousParameters[prm->number]!=data;
-		currentPreset.continuousParameters[prm->number]=data;
+		change=currentPreset->continuousParameters[prm->number]!=data;
+		currentPreset->continuousParameters[prm->number]=data;
 		break;
 	case ptStep:
 		if(source<0)
 			data=potSetting;
 		else
-			data=(currentPreset.steppedParameters[prm->number]+1)%valueCount;
+			data=(currentPreset->steppedParameters[prm->number]+1)%valueCount;
 
-		change=currentPreset.steppedParameters[prm->number]!=data;
-		currentPreset.steppedParameters[prm->number]=data;
+		change=currentPreset->steppedParameters[prm->number]!=data;
+		currentPreset->steppedParameters[prm->number]=data;
 		
 		// special cases
 		if(change)
@@ -1063,7 +1064,7 @@ static void scanEvent(int8_t source, uint16_t * forcedValue) // source: keypad (
 			case spBBank_Unsaved:
 			case spAXOvrBank_Unsaved:
 			case spBXOvrBank_Unsaved:
-				synth_getBankName(data,currentPreset.oscBank[sp2abx[prm->number]]);
+				synth_getBankName(data,currentPreset->oscBank[sp2abx[prm->number]]);
 
 				// waveform changes
 				ui.slowUpdateTimeout=currentTick+SLOW_UPDATE_TIMEOUT;
@@ -1073,7 +1074,7 @@ static void scanEvent(int8_t source, uint16_t * forcedValue) // source: keypad (
 			case spBWave_Unsaved:
 			case spAXOvrWave_Unsaved:
 			case spBXOvrWave_Unsaved:
-				synth_getWaveName(data,currentPreset.oscWave[sp2abx[prm->number]]);
+				synth_getWaveName(data,currentPreset->oscWave[sp2abx[prm->number]]);
 
 				// waveform changes
 				ui.slowUpdateTimeout=currentTick+SLOW_UPDATE_TIMEOUT;
@@ -1102,7 +1103,7 @@ static void scanEvent(int8_t source, uint16_t * forcedValue) // source: keypad (
 			ui.slowUpdateTimeoutNumber=prm->number+0x80;
 			break;
 		case cnSave:
-			if(settings.presetNumber!=currentPreset.loadedPresetNumber && !ui.presetExistsWarning && preset_fileExists(settings.presetNumber))
+			if(settings.presetNumber!=currentPreset->loadedPresetNumber && !ui.presetExistsWarning && preset_fileExists(settings.presetNumber))
 			{
 				ui.presetExistsWarning=1;
 				break;
@@ -1169,19 +1170,19 @@ static void scanEvent(int8_t source, uint16_t * forcedValue) // source: keypad (
 			settingsModified=1;
 			break;
 		case cnAXoSw:
-			swap8(&currentPreset.steppedParameters[spAXOvrBank_Unsaved],&currentPreset.steppedParameters[spABank_Unsaved]);
-			swap8(&currentPreset.steppedParameters[spAXOvrWave_Unsaved],&currentPreset.steppedParameters[spAWave_Unsaved]);
-			swapstr(currentPreset.oscBank[2],currentPreset.oscBank[0]);
-			swapstr(currentPreset.oscWave[2],currentPreset.oscWave[0]);
+			swap8(&currentPreset->steppedParameters[spAXOvrBank_Unsaved],&currentPreset->steppedParameters[spABank_Unsaved]);
+			swap8(&currentPreset->steppedParameters[spAXOvrWave_Unsaved],&currentPreset->steppedParameters[spAWave_Unsaved]);
+			swapstr(currentPreset->oscBank[2],currentPreset->oscBank[0]);
+			swapstr(currentPreset->oscWave[2],currentPreset->oscWave[0]);
 			synth_refreshWaveforms(abxAMain);
 			synth_refreshWaveforms(abxACrossover);
 			change=1;
 			break;
 		case cnBXoSw:
-			swap8(&currentPreset.steppedParameters[spBXOvrBank_Unsaved],&currentPreset.steppedParameters[spBBank_Unsaved]);
-			swap8(&currentPreset.steppedParameters[spBXOvrWave_Unsaved],&currentPreset.steppedParameters[spBWave_Unsaved]);
-			swapstr(currentPreset.oscBank[3],currentPreset.oscBank[1]);
-			swapstr(currentPreset.oscWave[3],currentPreset.oscWave[1]);
+			swap8(&currentPreset->steppedParameters[spBXOvrBank_Unsaved],&currentPreset->steppedParameters[spBBank_Unsaved]);
+			swap8(&currentPreset->steppedParameters[spBXOvrWave_Unsaved],&currentPreset->steppedParameters[spBWave_Unsaved]);
+			swapstr(currentPreset->oscBank[3],currentPreset->oscBank[1]);
+			swapstr(currentPreset->oscWave[3],currentPreset->oscWave[1]);
 			synth_refreshWaveforms(abxBMain);
 			synth_refreshWaveforms(abxBCrossover);
 			change=1;
@@ -1250,22 +1251,22 @@ static void scanEvent(int8_t source, uint16_t * forcedValue) // source: keypad (
 		case cnWEnT:
 			getDisplayValue(source,&data);
 			data=(data+1)&3;
-			currentPreset.steppedParameters[spWModEnvSlow]=data&1;
-			currentPreset.steppedParameters[spWModEnvLin]=data>>1;
+			currentPreset->steppedParameters[spWModEnvSlow]=data&1;
+			currentPreset->steppedParameters[spWModEnvLin]=data>>1;
 			change=1;
 			break;
 		case cnFEnT:
 			getDisplayValue(source,&data);
 			data=(data+1)&3;
-			currentPreset.steppedParameters[spFilEnvSlow]=data&1;
-			currentPreset.steppedParameters[spFilEnvLin]=data>>1;
+			currentPreset->steppedParameters[spFilEnvSlow]=data&1;
+			currentPreset->steppedParameters[spFilEnvLin]=data>>1;
 			change=1;
 			break;
 		case cnAEnT:
 			getDisplayValue(source,&data);
 			data=(data+1)&3;
-			currentPreset.steppedParameters[spAmpEnvSlow]=data&1;
-			currentPreset.steppedParameters[spAmpEnvLin]=data>>1;
+			currentPreset->steppedParameters[spAmpEnvSlow]=data&1;
+			currentPreset->steppedParameters[spAmpEnvLin]=data>>1;
 			change=1;
 			break;
 		case cnHelp:
@@ -1287,7 +1288,7 @@ static void scanEvent(int8_t source, uint16_t * forcedValue) // source: keypad (
 	
 	if(settingsModified)
 	{
-		ui.settingsModifiedTimeout=currentTick+ACTIVE_SOURCE_TIMEOUT;
+		settings_requestSave();
 		synth_refreshFullState(0);
 	}
 }
@@ -1340,7 +1341,7 @@ static void handleSlowUpdates(void)
 		{
 			synth_silenceSynth();
 			
-			settings_save();                
+			settings_requestSave();
 			if(!preset_loadCurrent(settings.presetNumber))
 				preset_loadDefault(1);
 			ui_setPresetModified(0);	
@@ -1363,7 +1364,7 @@ static void handleSlowUpdates(void)
 	case 0x80+cnTune:
 		setPos(2,0,1);
 		tuner_tuneSynth();
-		settings_save();
+		settings_requestSave();
 		synth_refreshFullState(0);
 		ui.pendingScreenClear=1;
 		break;
@@ -1372,6 +1373,7 @@ static void handleSlowUpdates(void)
 		{
 			setPos(2,0,1);
 			sendString(2,"USB Disk mode, press any button to quit");
+			settings_flush();
 			usb_setMode(umMSC,usbMSCCallback);
 
 			setPos(2,0,1);
@@ -1379,7 +1381,10 @@ static void handleSlowUpdates(void)
 
 			// reload settings & load static stuff
 			settings_load();
+			synth_invalidateWaveIndexes();
 			synth_refreshBankNames(1,1);
+			preset_dropStaleBinaries();
+			preset_invalidateCache();
 
 			synth_refreshFullState(1);
 			ui.pendingScreenClear=1;
@@ -1443,9 +1448,10 @@ void ui_init(void)
 	ui.prevPressedButton=-1;
 	ui.kpInputDecade=-1;
 	ui.kpInputPot=-1;
-	ui.settingsModifiedTimeout=UINT32_MAX;
 	ui.activeSourceTimeout=0;
 	ui.slowUpdateTimeout=UINT32_MAX;
+	for(int8_t v=0;v<SYNTH_VOICE_COUNT;++v)
+		ui.visualEnv[v]=INT8_MIN;
 
 	precalcDeadband(&panelDeadband);
 	
@@ -1501,14 +1507,6 @@ void ui_update(void)
 
 	handleSlowUpdates();
 
-	// to store changes made to settings thru UI
-
-	if(currentTick>ui.settingsModifiedTimeout)
-	{
-		settings_save();
-		ui.settingsModifiedTimeout=UINT32_MAX;
-	}
-		
 	// display
 	
 		// don't go fullscreen if more than one source is edited at the same time
@@ -1558,7 +1556,7 @@ void ui_update(void)
 		}
 		else
 		{
-			drawWaveform(synth_getWaveformData(sp2abx[prm->number]),WTOSC_SAMPLE_COUNT,currentPreset.oscWave[sp2abx[prm->number]]);
+			drawWaveform(synth_getWaveformData(sp2abx[prm->number]),WTOSC_SAMPLE_COUNT,currentPreset->oscWave[sp2abx[prm->number]]);
 		}
 	}
 	else if(ui.activePage==upHelp)
@@ -1671,13 +1669,13 @@ void ui_update(void)
 			char buf[60];
 			
 			memset(buf,0,sizeof(buf));
-			if(currentPreset.loadedPresetNumber<0)
+			if(currentPreset->loadedPresetNumber<0)
 			{
-				srprintf(buf,"???:%s",currentPreset.presetName);
+				srprintf(buf,"???:%s",currentPreset->presetName);
 			}
 			else
 			{
-				srprintf(buf,"%03d:%s",currentPreset.loadedPresetNumber,currentPreset.presetName);
+				srprintf(buf,"%03d:%s",currentPreset->loadedPresetNumber,currentPreset->presetName);
 			}
 			setPos(1,0,1); sendString(1,&buf[28]);
 			buf[28]='\0';
@@ -14,7 +14,7 @@ enum uiParamType_e
 
 enum uiPage_e
 {
-	upHelp,upOscs,upWMod,upFil,upAmp,upLFO1,upLFO2,upArp,upSeqPlay,upSeqRec,upMisc,upPresets,
+	upHelp,upOscs,upWMod,upFil,upAmp,upLFO1,upLFO2,upArp,upSeqPlay,upSeqRec,upMisc,upPresets,upEnvs,
 
 	// /!\ this must stay last
 	upCount
@@ -27,7 +27,7 @@ enum uiCustomParamNumber_e
 	cnWEnT,cnFEnT,cnAEnT,cnHelp,
 };
 
-#define UIP_MAX_VALUES 10
+#define UIP_MAX_VALUES 16
 #define UIPF_NO_REACQUIRE 1
 
 struct uiParam_s
@@ -124,7 +124,7 @@ const struct uiParam_s uiParameters[upCount][SCAN_POT_COUNT+(kbAsterisk-kbA+1)]
 		{.type=ptCont,.number=cpFilRel,.shortName="FRel",.longName="Filter Release"},
 		{.type=ptCont,.number=cpFilVelocity,.shortName="FVel",.longName="Filter Velocity"},
 		/* buttons (A,B,C,D,#,*) */
-		{.type=ptNone},
+		{.type=ptStep,.number=spGlideMode,.shortName="GldM",.longName="Glide Mode (oscs & filter tracking)",.values={"Lin ","Exp "}},
 		{.type=ptNone},
 		{.type=ptCust,.number=cnFEnT,.shortName="FEnT",.longName="Filter Envelope Type",.values={"FExp","SExp","FLin","SLin"}},
 		{.type=ptStep,.number=spFilEnvLoop,.shortName="FEnL",.longName="Filter Envelope Loop",.values={"Norm","Loop"}},
@@ -138,7 +138,7 @@ const struct uiParam_s uiParameters[upCount][SCAN_POT_COUNT+(kbAsterisk-kbA+1)]
 		{.type=ptCont,.number=cpGlide,.shortName="Glid",.longName="Glide amount"},
 		{.type=ptCont,.number=cpUnisonDetune,.shortName="MDet",.longName="Master unison Detune"},
 		{.type=ptCont,.number=cpMasterTune,.shortName="MTun",.longName="Master Tune"},
-		{.type=ptStep,.number=spVoiceCount,.shortName="VCnt",.longName="Voice count",.values={"   1","   2","   3","   4","   5","   6"}},
+		{.type=ptStep,.number=spVoiceCount,.shortName="VCnt",.longName="Voice count",.values={"   1","   2","   3","   4","   5","   6","   7","   8","   9","  10","  11","  12","  13","  14","  15","  16"}},
 		/* 2nd row of pots */
 		{.type=ptCont,.number=cpAmpAtt,.shortName="AAtk",.longName="Amplifier Attack"},
 		{.type=ptCont,.number=cpAmpDec,.shortName="ADec",.longName="Amplifier Decay"},
@@ -159,7 +159,7 @@ const struct uiParam_s uiParameters[upCount][SCAN_POT_COUNT+(kbAsterisk-kbA+1)]
 		{.type=ptCont,.number=cpLFOFreq,.shortName="1Spd",.longName="LFO1 Speed (BPM)"},
 		{.type=ptCont,.number=cpLFOAmt,.shortName="1Amt",.longName="LFO1 Amount (base)"},
 		{.type=ptStep,.number=spLFOShape,.shortName="1Wav",.longName="LFO1 Waveform",.values={"Sqr ","Tri ","Rand","Sine","Nois","Saw ","RSaw"}},
-		{.type=ptNone},
+		{.type=ptStep,.number=spLFOSync,.shortName="1Syn",.longName="LFO1 Clock sync (period in clock steps)",.values={"Off ","8Stp","4Stp","2Stp","1Stp","1/2 ","1/4 ","1/8 "}},
 		{.type=ptCont,.number=cpModDelay,.shortName="MDly",.longName="Modulation Delay"},
 		/* 2nd row of pots */
 		{.type=ptCont,.number=cpLFOPitchAmt,.shortName="1Pit",.longName="Pitch LFO1 Amount"},
@@ -171,7 +171,7 @@ const struct uiParam_s uiParameters[upCount][SCAN_POT_COUNT+(kbAsterisk-kbA+1)]
 		{.type=ptStep,.number=spLFOSpeed,.shortName="1Spd",.longName="LFO1 Speed multiplier",.values={"  x1","  x2","  x4","  x8"}},
 		{.type=ptStep,.number=spLFOTargets,.shortName="1Tgt",.longName="LFO1 Osc Target",.values={"None","OscA","OscB","Both"}},
 		{.type=ptStep,.number=spLFOTrig,.shortName="1Trg",.longName="LFO1 Keyboard Trigger",.values={"Free","Trig","HPer","1Per","2Per","4Per","8Per"}},
-		{.type=ptNone},
+		{.type=ptStep,.number=spLFOPerVoice,.shortName="1Voi",.longName="LFO1 Global or Per voice",.values={"Glob","Voic"}},
 		{.type=ptCust,.number=cnTrspM,.shortName="Trsp",.longName="Keyboard Transpose",.values={"Off ","Once","On  "}},
 		{.type=ptCust,.number=cnNVal,.shortName="NVal",.longName="Set last potentiometer digits"},
 	},
@@ -181,7 +181,7 @@ const struct uiParam_s uiParameters[upCount][SCAN_POT_COUNT+(kbAsterisk-kbA+1)]
 		{.type=ptCont,.number=cpLFO2Freq,.shortName="2Spd",.longName="LFO2 Speed (BPM)"},
 		{.type=ptCont,.number=cpLFO2Amt,.shortName="2Amt",.longName="LFO2 Amount (base)"},
 		{.type=ptStep,.number=spLFO2Shape,.shortName="2Wav",.longName="LFO2 Waveform",.values={"Sqr ","Tri ","Rand","Sine","Nois","Saw ","RSaw"}},
-		{.type=ptNone},
+		{.type=ptStep,.number=spLFO2Sync,.shortName="2Syn",.longName="LFO2 Clock sync (period in clock steps)",.values={"Off ","8Stp","4Stp","2Stp","1Stp","1/2 ","1/4 ","1/8 "}},
 		{.type=ptCont,.number=cpModDelay,.shortName="MDly",.longName="Modulation Delay"},
 		/* 2nd row of pots */
 		{.type=ptCont,.number=cpLFO2PitchAmt,.shortName="2Pit",.longName="Pitch LFO2 Amount"},
@@ -193,7 +193,7 @@ const struct uiParam_s uiParameters[upCount][SCAN_POT_COUNT+(kbAsterisk-kbA+1)]
 		{.type=ptStep,.number=spLFO2Speed,.shortName="2Spd",.longName="LFO2 Speed multiplier",.values={"  x1","  x2","  x4","  x8"}},
 		{.type=ptStep,.number=spLFO2Targets,.shortName="2Tgt",.longName="LFO2 Osc Target",.values={"None","OscA","OscB","Both"}},
 		{.type=ptStep,.number=spLFO2Trig,.shortName="2Trg",.longName="LFO2 Keyboard Trigger",.values={"Free","Trig","HPer","1Per","2Per","4Per","8Per"}},
-		{.type=ptNone},
+		{.type=ptStep,.number=spLFO2PerVoice,.shortName="2Voi",.longName="LFO2 Global or Per voice",.values={"Glob","Voic"}},
 		{.type=ptCust,.number=cnTrspM,.shortName="Trsp",.longName="Keyboard Transpose",.values={"Off ","Once","On  "}},
 		{.type=ptCust,.number=cnNVal,.shortName="NVal",.longName="Set last potentiometer digits"},
 	},
@@ -307,6 +307,28 @@ const struct uiParam_s uiParameters[upCount][SCAN_POT_COUNT+(kbAsterisk-kbA+1)]
 		{.type=ptCust,.number=cnTrspM,.shortName="Trsp",.longName="Keyboard Transpose",.values={"Off ","Once","On  "}},
 		{.type=ptCust,.number=cnNPrs,.shortName="NPrs",.longName="Set preset number digits"},
 	},
+	/* Envelopes delay/hold/curves page (2, 3 or 4 twice) */
+	{
+		/* 1st row of pots */
+		{.type=ptCont,.number=cpWModDly,.shortName="WDly",.longName="WaveMod Delay"},
+		{.type=ptCont,.number=cpWModHld,.shortName="WHld",.longName="WaveMod Hold"},
+		{.type=ptCont,.number=cpFilDly,.shortName="FDly",.longName="Filter Delay"},
+		{.type=ptCont,.number=cpFilHld,.shortName="FHld",.longName="Filter Hold"},
+		{.type=ptNone},
+		/* 2nd row of pots */
+		{.type=ptNone},
+		{.type=ptNone},
+		{.type=ptNone},
+		{.type=ptCont,.number=cpAmpDly,.shortName="ADly",.longName="Amplifier Delay"},
+		{.type=ptCont,.number=cpAmpHld,.shortName="AHld",.longName="Amplifier Hold"},
+		/* buttons (A,B,C,D,#,*) */
+		{.type=ptStep,.number=spWModEnvCurves,.shortName="WEnC",.longName="WaveMod Envelope flipped curves",.values={"None","A   "," D  ","AD  ","  R ","A R "," DR ","ADR "}},
+		{.type=ptStep,.number=spFilEnvCurves,.shortName="FEnC",.longName="Filter Envelope flipped curves",.values={"None","A   "," D  ","AD  ","  R ","A R "," DR ","ADR "}},
+		{.type=ptStep,.number=spAmpEnvCurves,.shortName="AEnC",.longName="Amplifier Envelope flipped curves",.values={"None","A   "," D  ","AD  ","  R ","A R "," DR ","ADR "}},
+		{.type=ptStep,.number=spAmpEnvDigital,.shortName="AEnD",.longName="Amplifier Envelope on (VCA) or in oscs (Digital)",.values={"VCA ","Digi"}},
+		{.type=ptCust,.number=cnTrspM,.shortName="Trsp",.longName="Keyboard Transpose",.values={"Off ","Once","On  "}},
+		{.type=ptCust,.number=cnNVal,.shortName="NVal",.longName="Set last potentiometer digits"},
+	},
 };
 
 #endif /* UI_PAGES_H */
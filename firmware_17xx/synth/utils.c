@@ -4,6 +4,7 @@
 
 #include "main.h"
 #include "utils.h"
+#include "utils_lookups.h"
 
 inline uint16_t satAddU16U16(uint16_t a, uint16_t b)
 {
@@ -68,37 +69,82 @@ inline uint16_t herp(int32_t alpha, int32_t cur, int32_t prev, int32_t prev2, in
 	return r;
 }
 
-void resample(const uint16_t * src, uint16_t * dst, uint16_t src_samples, uint16_t dst_samples)
+static void resampleHermite(const uint16_t * src, uint16_t * dst, uint16_t src_samples, uint16_t dst_samples)
 {
-	if(src_samples==dst_samples)
+	const int8_t frac_shift=14;
+	int32_t counter=0, increment=(src_samples<<frac_shift)/dst_samples;
+	int32_t c,p1,p2,p3;
+
+	p1=src[(src_samples-((increment*1)>>frac_shift))%src_samples];
+	p2=src[(src_samples-((increment*2)>>frac_shift))%src_samples];
+	p3=src[(src_samples-((increment*3)>>frac_shift))%src_samples];
+
+	for(uint16_t ds=0;ds<dst_samples;++ds)
 	{
-		memcpy(dst,src,src_samples*sizeof(uint16_t));
+		c=src[counter>>frac_shift];
+
+		*dst++=herp(counter&((1<<frac_shift)-1),c,p1,p2,p3,frac_shift);
+
+		p3=p2;
+		p2=p1;
+		p1=c;
+
+		counter+=increment;
 	}
-	else
+}
+
+static FORCEINLINE int32_t wrapIndex(int32_t idx, uint16_t src_samples)
+{
+	return ((idx%src_samples)+src_samples)%src_samples;
+}
+
+// polyphase windowed sinc, for upsampling
+static void resampleSincUp(const uint16_t * src, uint16_t * dst, uint16_t src_samples, uint16_t dst_samples)
+{
+	const int8_t frac_shift=16;
+	uint32_t counter=0, increment=((uint32_t)src_samples<<frac_shift)/dst_samples;
+	uint16_t head[RESAMPLE_SINC_TAPS];
+	int32_t i,idx,s,acc;
+	const int16_t * k;
+
+	// taps wrap around to the start of src, which dst might have overwritten by then
+	for(i=0;i<RESAMPLE_SINC_TAPS;++i)
+		head[i]=src[i%src_samples];
+
+	for(uint16_t ds=0;ds<dst_samples;++ds)
 	{
-		const int8_t frac_shift=14;
-		int32_t counter=0, increment=(src_samples<<frac_shift)/dst_samples;
-		int32_t c,p1,p2,p3;
-		
-		p1=src[(src_samples-((increment*1)>>frac_shift))%src_samples];
-		p2=src[(src_samples-((increment*2)>>frac_shift))%src_samples];
-		p3=src[(src_samples-((increment*3)>>frac_shift))%src_samples];
-		
-		for(uint16_t ds=0;ds<dst_samples;++ds)
+		k=resampleSincLookup[(counter>>(frac_shift-RESAMPLE_SINC_PHASE_BITS))&((1<<RESAMPLE_SINC_PHASE_BITS)-1)];
+		idx=(int32_t)(counter>>frac_shift)-(RESAMPLE_SINC_TAPS/2-1);
+		acc=0;
+
+		for(i=0;i<RESAMPLE_SINC_TAPS;++i,++idx)
 		{
-			c=src[counter>>frac_shift];
-			
-			*dst++=herp(counter&((1<<frac_shift)-1),c,p1,p2,p3,frac_shift);
-
-			p3=p2;
-			p2=p1;
-			p1=c;
-			
-			counter+=increment;
+			if(idx<0)
+				s=src[wrapIndex(idx,src_samples)];
+			else if(idx>=src_samples)
+				s=head[idx-src_samples];
+			else
+				s=src[idx];
+
+			acc+=s*k[i];
 		}
+
+		*dst++=__USAT((acc+(1<<13))>>14,16);
+
+		counter+=increment;
 	}
 }
 
+void resample(const uint16_t * src, uint16_t * dst, uint16_t src_samples, uint16_t dst_samples, resampleMode_t mode)
+{
+	if(src_samples==dst_samples)
+		memmove(dst,src,src_samples*sizeof(uint16_t)); // src and dst may overlap
+	else if(mode==rmSinc && src_samples<dst_samples)
+		resampleSincUp(src,dst,src_samples,dst_samples);
+	else
+		resampleHermite(src,dst,src_samples,dst_samples);
+}
+
 // phase is 20 bits, from bit 4 to bit 23
 inline uint16_t computeShape(uint32_t phase, const uint16_t lookup[], int8_t interpolate)
 {
@@ -169,24 +215,56 @@ inline int16_t scaleU16S16(uint16_t a, int16_t b)
 	return r;
 }
 
+uint32_t hashBytes(uint32_t h, const void * data, uint32_t size)
+{
+	const uint8_t * p=data;
+	
+	while(size--)
+	{
+		h^=*p++;
+		h*=16777619UL;
+	}
+	
+	return h;
+}
+
 inline uint32_t lfsr(uint32_t v, uint8_t taps)
 {
-	uint8_t b24;
+	uint8_t n;
+	uint32_t fb;
+	
+	// feedback taps are bits 31,29,25,24, so up to 24 steps only depend on the
+	// initial value and can be computed at once (step k feeds back v[31-k]^v[29-k]^v[25-k]^v[24-k])
 	
-	while(taps--)
+	while(taps)
 	{
-		b24=v>>24;
-		
-		v<<=1;
-		v|=((b24>>7)^(b24>>5)^(b24>>1)^b24)&1;
+		n=MIN(taps,24);
+		taps-=n;
+
+		fb=(v>>(32-n))^(v>>(30-n))^(v>>(26-n))^(v>>(25-n));
+
+		v=(v<<n)|(fb&((1UL<<n)-1));
 	}
 	
 	return v;
 }
 
-uint16_t exponentialCourse(uint16_t v, float ratio, float range)
+uint16_t exp2NegFixed(uint32_t x, uint16_t range)
 {
-	return expf(-(float)v/ratio)*range;
+	uint8_t ip,idx,frac;
+	uint32_t v;
+	
+	ip=x>>16;
+	if(ip>=16)
+		return 0;
+	
+	idx=x>>8;
+	frac=x;
+	
+	v=exp2NegLookup[idx];
+	v-=((v-exp2NegLookup[idx+1])*frac)>>8;
+	
+	return (v*range)>>(16+ip);
 }
 
 uint16_t linearCourse(uint16_t v, float ratio, float range)
@@ -32,12 +32,28 @@ int16_t scaleU16S16(uint16_t a, int16_t b);
 uint16_t lerp(uint16_t a,uint16_t b,uint8_t x);
 uint16_t lerp16(uint16_t a,uint16_t b,uint16_t x);
 uint16_t herp(int32_t alpha, int32_t cur, int32_t prev, int32_t prev2, int32_t prev3, int8_t frac_shift);
-void resample(const uint16_t * src, uint16_t * dst, uint16_t src_samples, uint16_t dst_samples);
+
+#define RESAMPLE_SINC_TAPS 16
+#define RESAMPLE_SINC_PHASE_BITS 8
+
+typedef enum
+{
+	rmHermite=0,rmSinc=1
+} resampleMode_t;
+
+// src is one wave cycle, dst may overlap src when src ends at least RESAMPLE_SINC_TAPS/2 samples after dst
+// rmSinc only upsamples (the wave loader never has more samples than WTOSC_SAMPLE_COUNT), downsampling is rmHermite
+void resample(const uint16_t * src, uint16_t * dst, uint16_t src_samples, uint16_t dst_samples, resampleMode_t mode);
 uint16_t computeShape(uint32_t phase, const uint16_t lookup[], int8_t interpolate);
 
 uint32_t lfsr(uint32_t v, uint8_t taps);
 
-uint16_t exponentialCourse(uint16_t v, float ratio, float range);
+#define HASH_INIT 2166136261UL
+uint32_t hashBytes(uint32_t h, const void * data, uint32_t size); // FNV-1a, start with h=HASH_INIT
+
+uint16_t exp2NegFixed(uint32_t x, uint16_t range); // range*2^-x, x is 16.16 fixed point
+// range*expf(-v/ratio), no float math at runtime if ratio is a constant, error vs expf() is at most 1
+#define exponentialCourse(v,ratio,range) exp2NegFixed(((uint64_t)(v)*(uint32_t)(16777216.0/((ratio)*M_LN2)))>>8,(range))
 uint16_t linearCourse(uint16_t v, float ratio, float range); // reverse of exponentialCourse
 		
 int uint16Compare(const void * a,const void * b); // for qsort
@@ -0,0 +1,287 @@
+#ifndef UTILS_LOOKUPS_H
+#define UTILS_LOOKUPS_H
+
+// 65536*2^(-i/256), first value clamped to 65535
+const uint16_t exp2NegLookup[257]=
+{
+	65535,65359,65182,65006,64830,64655,64480,64306,64132,63958,63785,63613,63441,63269,63098,62928,
+	62757,62588,62419,62250,62081,61914,61746,61579,61413,61247,61081,60916,60751,60587,60423,60260,
+	60097,59934,59772,59611,59449,59289,59128,58968,58809,58650,58491,58333,58176,58018,57861,57705,
+	57549,57393,57238,57083,56929,56775,56622,56468,56316,56163,56012,55860,55709,55558,55408,55258,
+	55109,54960,54811,54663,54515,54368,54221,54074,53928,53782,53637,53492,53347,53203,53059,52916,
+	52773,52630,52488,52346,52204,52063,51922,51782,51642,51502,51363,51224,51085,50947,50810,50672,
+	50535,50399,50262,50126,49991,49856,49721,49586,49452,49319,49185,49052,48920,48787,48655,48524,
+	48393,48262,48131,48001,47871,47742,47613,47484,47356,47228,47100,46973,46846,46719,46593,46467,
+	46341,46216,46091,45966,45842,45718,45594,45471,45348,45225,45103,44981,44859,44738,44617,44497,
+	44376,44256,44137,44017,43898,43780,43661,43543,43425,43308,43191,43074,42958,42841,42726,42610,
+	42495,42380,42265,42151,42037,41923,41810,41697,41584,41472,41360,41248,41136,41025,40914,40804,
+	40693,40583,40473,40364,40255,40146,40037,39929,39821,39714,39606,39499,39392,39286,39180,39074,
+	38968,38863,38757,38653,38548,38444,38340,38236,38133,38030,37927,37824,37722,37620,37518,37417,
+	37316,37215,37114,37014,36914,36814,36715,36615,36516,36417,36319,36221,36123,36025,35928,35831,
+	35734,35637,35541,35445,35349,35253,35158,35063,34968,34874,34779,34685,34591,34498,34405,34312,
+	34219,34126,34034,33942,33850,33759,33667,33576,33486,33395,33305,33215,33125,33035,32946,32857,
+	32768,
+};
+
+// windowed sinc (Kaiser, beta=8, cutoff 0.94*nyquist), 16 taps, 256 phases, each phase sums to 16384
+const int16_t resampleSincLookup[1<<RESAMPLE_SINC_PHASE_BITS][RESAMPLE_SINC_TAPS]=
+{
+	{17,-65,166,-329,540,-757,921,15398,921,-757,540,-329,166,-65,17,0},
+	{17,-64,164,-324,529,-733,862,15398,981,-781,552,-334,168,-66,17,-2},
+	{17,-64,162,-319,518,-709,803,15397,1042,-806,563,-339,170,-66,17,-2},
+	{17,-63,160,-314,506,-684,744,15395,1102,-830,574,-344,172,-67,18,-2},
+	{16,-62,158,-309,495,-660,686,15392,1164,-854,585,-349,174,-68,18,-2},
+	{16,-62,156,-304,484,-636,628,15389,1225,-879,597,-354,176,-68,18,-2},
+	{16,-61,154,-299,472,-612,570,15386,1287,-903,608,-359,178,-69,18,-2},
+	{16,-60,152,-294,461,-588,513,15381,1349,-927,619,-364,180,-70,18,-2},
+	{16,-60,150,-288,449,-564,456,15376,1412,-952,630,-369,182,-70,18,-2},
+	{16,-59,148,-283,438,-541,400,15370,1475,-976,641,-374,183,-71,19,-2},
+	{15,-58,146,-278,427,-517,344,15363,1538,-1001,653,-379,185,-71,19,-2},
+	{15,-58,143,-273,415,-493,289,15357,1602,-1025,664,-384,187,-72,19,-2},
+	{15,-57,141,-268,404,-469,234,15348,1666,-1050,675,-388,189,-73,19,-2},
+	{15,-56,139,-262,393,-446,179,15338,1730,-1074,686,-393,191,-73,19,-2},
+	{15,-56,137,-257,381,-422,125,15329,1795,-1098,697,-398,193,-74,19,-2},
+	{15,-55,135,-252,370,-399,71,15319,1860,-1123,708,-403,195,-74,19,-2},
+	{14,-54,133,-247,359,-376,18,15308,1925,-1147,719,-407,196,-75,20,-2},
+	{14,-53,131,-242,347,-352,-35,15297,1991,-1172,729,-412,198,-75,20,-2},
+	{14,-53,129,-236,336,-329,-87,15284,2057,-1196,740,-417,200,-76,20,-2},
+	{14,-52,127,-231,325,-306,-139,15269,2124,-1220,751,-421,202,-77,20,-2},
+	{14,-51,125,-226,313,-283,-191,15258,2190,-1245,762,-426,203,-77,20,-2},
+	{13,-51,122,-221,302,-260,-242,15245,2258,-1269,772,-430,205,-78,20,-2},
+	{13,-50,120,-216,291,-237,-292,15228,2325,-1293,783,-435,207,-78,20,-2},
+	{13,-49,118,-210,280,-215,-342,15211,2393,-1317,794,-439,208,-79,20,-2},
+	{13,-48,116,-205,269,-192,-392,15194,2461,-1342,804,-444,210,-79,21,-2},
+	{13,-48,114,-200,257,-169,-441,15177,2529,-1366,815,-448,212,-80,21,-2},
+	{13,-47,112,-195,246,-147,-490,15160,2598,-1390,825,-453,213,-80,21,-2},
+	{12,-46,110,-190,235,-125,-539,15144,2666,-1414,835,-457,215,-81,21,-2},
+	{12,-46,107,-184,224,-102,-586,15122,2736,-1438,846,-461,216,-81,21,-2},
+	{12,-45,105,-179,213,-80,-634,15103,2805,-1462,856,-465,218,-82,21,-2},
+	{12,-44,103,-174,202,-58,-681,15082,2875,-1486,866,-470,220,-82,21,-2},
+	{12,-43,101,-169,191,-36,-727,15060,2945,-1509,876,-474,221,-83,21,-2},
+	{12,-43,99,-164,180,-15,-773,15038,3015,-1533,886,-478,223,-83,22,-2},
+	{11,-42,97,-158,169,7,-819,15015,3086,-1557,896,-482,224,-83,22,-2},
+	{11,-41,95,-153,158,28,-864,14992,3157,-1580,906,-486,225,-84,22,-2},
+	{11,-41,92,-148,147,50,-908,14968,3228,-1604,916,-490,227,-84,22,-2},
+	{11,-40,90,-143,137,71,-952,14943,3299,-1627,926,-494,228,-85,22,-2},
+	{11,-39,88,-138,126,92,-996,14917,3371,-1650,935,-498,230,-85,22,-2},
+	{10,-38,86,-133,115,113,-1039,14892,3443,-1674,945,-502,231,-85,22,-2},
+	{10,-38,84,-128,104,134,-1082,14867,3515,-1697,954,-505,232,-86,22,-2},
+	{10,-37,82,-123,94,155,-1124,14837,3587,-1720,964,-509,234,-86,22,-2},
+	{10,-36,80,-117,83,175,-1166,14810,3660,-1743,973,-513,235,-87,22,-2},
+	{10,-35,78,-112,73,196,-1207,14781,3732,-1766,982,-516,236,-87,22,-3},
+	{10,-35,76,-107,62,216,-1247,14750,3805,-1788,992,-520,237,-87,23,-3},
+	{9,-34,73,-102,52,236,-1288,14722,3879,-1811,1001,-523,238,-88,23,-3},
+	{9,-33,71,-97,41,256,-1327,14690,3952,-1833,1010,-527,240,-88,23,-3},
+	{9,-33,69,-92,31,276,-1367,14660,4026,-1856,1018,-530,241,-88,23,-3},
+	{9,-32,67,-87,21,296,-1405,14626,4100,-1878,1027,-534,242,-88,23,-3},
+	{9,-31,65,-82,10,315,-1444,14595,4174,-1900,1036,-537,243,-89,23,-3},
+	{9,-31,63,-78,0,335,-1481,14561,4248,-1922,1045,-540,244,-89,23,-3},
+	{8,-30,61,-73,-10,354,-1519,14529,4322,-1944,1053,-543,245,-89,23,-3},
+	{8,-29,59,-68,-20,373,-1555,14494,4397,-1965,1061,-547,246,-90,23,-3},
+	{8,-28,57,-63,-30,392,-1592,14459,4471,-1987,1070,-550,247,-90,23,-3},
+	{8,-28,55,-58,-40,411,-1628,14423,4546,-2008,1078,-553,248,-90,23,-3},
+	{8,-27,53,-53,-50,429,-1663,14386,4622,-2030,1086,-556,249,-90,23,-3},
+	{8,-26,51,-48,-60,448,-1698,14347,4697,-2051,1094,-558,250,-90,23,-3},
+	{7,-26,49,-44,-69,466,-1732,14312,4772,-2072,1102,-561,251,-91,23,-3},
+	{7,-25,47,-39,-79,484,-1766,14273,4848,-2092,1110,-564,251,-91,23,-3},
+	{7,-24,45,-34,-89,502,-1799,14235,4923,-2113,1117,-567,252,-91,23,-3},
+	{7,-24,43,-29,-98,520,-1832,14193,4999,-2133,1125,-569,253,-91,23,-3},
+	{7,-23,41,-25,-108,537,-1864,14155,5075,-2154,1132,-572,254,-91,23,-3},
+	{7,-22,39,-20,-117,555,-1896,14113,5151,-2174,1139,-574,254,-91,23,-3},
+	{6,-22,37,-15,-127,572,-1927,14073,5227,-2194,1147,-577,255,-91,23,-3},
+	{6,-21,35,-11,-136,589,-1958,14030,5304,-2213,1154,-579,255,-91,23,-3},
+	{6,-20,33,-6,-145,606,-1989,13988,5380,-2233,1161,-581,256,-92,23,-3},
+	{6,-20,31,-2,-154,623,-2018,13945,5457,-2252,1167,-584,257,-92,23,-3},
+	{6,-19,29,3,-163,639,-2048,13902,5533,-2271,1174,-586,257,-92,23,-3},
+	{6,-18,27,7,-172,656,-2076,13855,5610,-2290,1181,-588,258,-92,23,-3},
+	{6,-18,25,12,-181,672,-2105,13812,5687,-2309,1187,-590,258,-92,23,-3},
+	{5,-17,23,16,-190,688,-2133,13769,5764,-2328,1193,-592,258,-92,23,-3},
+	{5,-16,21,21,-199,704,-2160,13721,5841,-2346,1199,-594,259,-92,23,-3},
+	{5,-16,19,25,-207,719,-2187,13675,5918,-2364,1205,-595,259,-92,23,-3},
+	{5,-15,17,29,-216,735,-2213,13628,5995,-2382,1211,-597,259,-92,23,-3},
+	{5,-14,16,34,-225,750,-2239,13579,6072,-2400,1217,-599,260,-92,23,-3},
+	{5,-14,14,38,-233,765,-2264,13530,6149,-2417,1223,-600,260,-92,23,-3},
+	{5,-13,12,42,-241,780,-2289,13482,6226,-2434,1228,-602,260,-92,23,-3},
+	{4,-13,10,46,-250,794,-2314,13435,6304,-2451,1233,-603,260,-91,23,-3},
+	{4,-12,8,51,-258,809,-2337,13383,6381,-2468,1239,-605,260,-91,23,-3},
+	{4,-11,7,55,-266,823,-2361,13332,6458,-2484,1244,-606,260,-91,23,-3},
+	{4,-11,5,59,-274,837,-2384,13282,6536,-2501,1248,-607,261,-91,23,-3},
+	{4,-10,3,63,-282,851,-2406,13230,6613,-2517,1253,-608,261,-91,23,-3},
+	{4,-9,1,67,-290,865,-2428,13177,6691,-2532,1258,-609,260,-91,23,-3},
+	{4,-9,-1,71,-298,878,-2449,13127,6768,-2548,1262,-610,260,-91,23,-3},
+	{3,-8,-2,75,-305,892,-2470,13073,6845,-2563,1266,-611,260,-90,22,-3},
+	{3,-8,-4,79,-313,905,-2491,13020,6923,-2578,1271,-612,260,-90,22,-3},
+	{3,-7,-6,83,-321,918,-2510,12966,7000,-2593,1274,-612,260,-90,22,-3},
+	{3,-7,-7,87,-328,930,-2530,12911,7078,-2607,1278,-613,260,-90,22,-3},
+	{3,-6,-9,90,-335,943,-2549,12855,7155,-2621,1282,-613,259,-89,22,-3},
+	{3,-5,-11,94,-343,955,-2567,12801,7232,-2635,1285,-614,259,-89,22,-3},
+	{3,-5,-12,98,-350,967,-2585,12743,7310,-2649,1289,-614,259,-89,22,-3},
+	{3,-4,-14,102,-357,979,-2603,12686,7387,-2662,1292,-614,258,-88,22,-3},
+	{2,-4,-16,105,-364,991,-2620,12631,7464,-2675,1295,-614,258,-88,22,-3},
+	{2,-3,-17,109,-371,1002,-2636,12575,7541,-2688,1298,-615,257,-88,21,-3},
+	{2,-3,-19,113,-378,1014,-2652,12516,7618,-2700,1300,-615,257,-87,21,-3},
+	{2,-2,-20,116,-384,1025,-2668,12457,7695,-2713,1303,-614,256,-87,21,-3},
+	{2,-2,-22,120,-391,1035,-2683,12399,7772,-2724,1305,-614,256,-87,21,-3},
+	{2,-1,-23,123,-397,1046,-2698,12338,7849,-2736,1307,-614,255,-86,21,-2},
+	{2,-1,-25,126,-404,1057,-2712,12280,7926,-2747,1309,-614,254,-86,21,-2},
+	{2,0,-26,130,-410,1067,-2725,12216,8003,-2758,1311,-613,254,-85,20,-2},
+	{2,0,-28,133,-416,1077,-2739,12159,8079,-2769,1313,-613,253,-85,20,-2},
+	{1,1,-29,137,-423,1087,-2751,12096,8156,-2779,1314,-612,252,-84,20,-2},
+	{1,1,-31,140,-429,1096,-2763,12037,8232,-2789,1315,-611,251,-84,20,-2},
+	{1,2,-32,143,-435,1106,-2775,11972,8309,-2798,1316,-610,250,-83,20,-2},
+	{1,2,-34,146,-440,1115,-2787,11912,8385,-2808,1317,-609,249,-83,20,-2},
+	{1,3,-35,149,-446,1124,-2797,11848,8461,-2817,1318,-608,248,-82,19,-2},
+	{1,3,-37,152,-452,1133,-2808,11786,8537,-2825,1319,-607,247,-82,19,-2},
+	{1,4,-38,155,-458,1142,-2818,11722,8613,-2834,1319,-606,246,-81,19,-2},
+	{1,4,-39,158,-463,1150,-2827,11659,8688,-2842,1319,-605,245,-81,19,-2},
+	{1,5,-41,161,-468,1158,-2836,11592,8764,-2849,1319,-603,244,-80,19,-2},
+	{0,5,-42,164,-474,1166,-2845,11531,8839,-2857,1319,-602,243,-79,18,-2},
+	{0,6,-43,167,-479,1174,-2853,11464,8914,-2863,1318,-600,242,-79,18,-2},
+	{0,6,-45,170,-484,1181,-2861,11401,8989,-2870,1318,-599,240,-78,18,-2},
+	{0,7,-46,173,-489,1189,-2868,11332,9064,-2876,1317,-597,239,-77,18,-2},
+	{0,7,-47,176,-494,1196,-2875,11267,9139,-2882,1316,-595,238,-77,17,-2},
+	{0,7,-48,178,-499,1203,-2881,11201,9213,-2887,1315,-593,236,-76,17,-2},
+	{0,8,-50,181,-503,1210,-2887,11132,9288,-2893,1314,-591,235,-75,17,-2},
+	{0,8,-51,184,-508,1216,-2892,11065,9362,-2897,1312,-589,233,-74,17,-2},
+	{0,9,-52,186,-512,1223,-2897,10997,9436,-2902,1311,-587,232,-74,16,-2},
+	{0,9,-53,189,-517,1229,-2902,10930,9509,-2906,1309,-584,230,-73,16,-2},
+	{0,10,-54,191,-521,1235,-2906,10860,9583,-2909,1307,-582,228,-72,16,-2},
+	{0,10,-55,194,-525,1240,-2910,10792,9656,-2912,1304,-579,227,-71,15,-2},
+	{-1,10,-56,196,-530,1246,-2913,10724,9729,-2915,1302,-577,225,-70,15,-1},
+	{-1,11,-58,198,-534,1251,-2916,10656,9802,-2918,1299,-574,223,-69,15,-1},
+	{-1,11,-59,201,-537,1256,-2918,10587,9874,-2920,1296,-571,221,-69,14,-1},
+	{-1,11,-60,203,-541,1261,-2920,10515,9947,-2921,1293,-568,220,-68,14,-1},
+	{-1,12,-61,205,-545,1266,-2922,10445,10019,-2923,1290,-565,218,-67,14,-1},
+	{-1,12,-62,207,-549,1270,-2923,10377,10090,-2924,1286,-562,216,-66,14,-1},
+	{-1,12,-63,210,-552,1275,-2924,10304,10162,-2924,1283,-559,214,-65,13,-1},
+	{-1,13,-64,212,-556,1279,-2924,10233,10233,-2924,1279,-556,212,-64,13,-1},
+	{-1,13,-65,214,-559,1283,-2924,10162,10304,-2924,1275,-552,210,-63,12,-1},
+	{-1,14,-66,216,-562,1286,-2924,10090,10377,-2923,1270,-549,207,-62,12,-1},
+	{-1,14,-67,218,-565,1290,-2923,10019,10445,-2922,1266,-545,205,-61,12,-1},
+	{-1,14,-68,220,-568,1293,-2921,9947,10515,-2920,1261,-541,203,-60,11,-1},
+	{-1,14,-69,221,-571,1296,-2920,9874,10587,-2918,1256,-537,201,-59,11,-1},
+	{-1,15,-69,223,-574,1299,-2918,9802,10656,-2916,1251,-534,198,-58,11,-1},
+	{-1,15,-70,225,-577,1302,-2915,9729,10724,-2913,1246,-530,196,-56,10,-1},
+	{-2,15,-71,227,-579,1304,-2912,9656,10792,-2910,1240,-525,194,-55,10,0},
+	{-2,16,-72,228,-582,1307,-2909,9583,10860,-2906,1235,-521,191,-54,10,0},
+	{-2,16,-73,230,-584,1309,-2906,9509,10930,-2902,1229,-517,189,-53,9,0},
+	{-2,16,-74,232,-587,1311,-2902,9436,10997,-2897,1223,-512,186,-52,9,0},
+	{-2,17,-74,233,-589,1312,-2897,9362,11065,-2892,1216,-508,184,-51,8,0},
+	{-2,17,-75,235,-591,1314,-2893,9288,11132,-2887,1210,-503,181,-50,8,0},
+	{-2,17,-76,236,-593,1315,-2887,9213,11201,-2881,1203,-499,178,-48,7,0},
+	{-2,17,-77,238,-595,1316,-2882,9139,11267,-2875,1196,-494,176,-47,7,0},
+	{-2,18,-77,239,-597,1317,-2876,9064,11332,-2868,1189,-489,173,-46,7,0},
+	{-2,18,-78,240,-599,1318,-2870,8989,11401,-2861,1181,-484,170,-45,6,0},
+	{-2,18,-79,242,-600,1318,-2863,8914,11464,-2853,1174,-479,167,-43,6,0},
+	{-2,18,-79,243,-602,1319,-2857,8839,11531,-2845,1166,-474,164,-42,5,0},
+	{-2,19,-80,244,-603,1319,-2849,8764,11592,-2836,1158,-468,161,-41,5,1},
+	{-2,19,-81,245,-605,1319,-2842,8688,11659,-2827,1150,-463,158,-39,4,1},
+	{-2,19,-81,246,-606,1319,-2834,8613,11722,-2818,1142,-458,155,-38,4,1},
+	{-2,19,-82,247,-607,1319,-2825,8537,11786,-2808,1133,-452,152,-37,3,1},
+	{-2,19,-82,248,-608,1318,-2817,8461,11848,-2797,1124,-446,149,-35,3,1},
+	{-2,20,-83,249,-609,1317,-2808,8385,11912,-2787,1115,-440,146,-34,2,1},
+	{-2,20,-83,250,-610,1316,-2798,8309,11972,-2775,1106,-435,143,-32,2,1},
+	{-2,20,-84,251,-611,1315,-2789,8232,12037,-2763,1096,-429,140,-31,1,1},
+	{-2,20,-84,252,-612,1314,-2779,8156,12096,-2751,1087,-423,137,-29,1,1},
+	{-2,20,-85,253,-613,1313,-2769,8079,12159,-2739,1077,-416,133,-28,0,2},
+	{-2,20,-85,254,-613,1311,-2758,8003,12216,-2725,1067,-410,130,-26,0,2},
+	{-2,21,-86,254,-614,1309,-2747,7926,12280,-2712,1057,-404,126,-25,-1,2},
+	{-2,21,-86,255,-614,1307,-2736,7849,12338,-2698,1046,-397,123,-23,-1,2},
+	{-3,21,-87,256,-614,1305,-2724,7772,12399,-2683,1035,-391,120,-22,-2,2},
+	{-3,21,-87,256,-614,1303,-2713,7695,12457,-2668,1025,-384,116,-20,-2,2},
+	{-3,21,-87,257,-615,1300,-2700,7618,12516,-2652,1014,-378,113,-19,-3,2},
+	{-3,21,-88,257,-615,1298,-2688,7541,12575,-2636,1002,-371,109,-17,-3,2},
+	{-3,22,-88,258,-614,1295,-2675,7464,12631,-2620,991,-364,105,-16,-4,2},
+	{-3,22,-88,258,-614,1292,-2662,7387,12686,-2603,979,-357,102,-14,-4,3},
+	{-3,22,-89,259,-614,1289,-2649,7310,12743,-2585,967,-350,98,-12,-5,3},
+	{-3,22,-89,259,-614,1285,-2635,7232,12801,-2567,955,-343,94,-11,-5,3},
+	{-3,22,-89,259,-613,1282,-2621,7155,12855,-2549,943,-335,90,-9,-6,3},
+	{-3,22,-90,260,-613,1278,-2607,7078,12911,-2530,930,-328,87,-7,-7,3},
+	{-3,22,-90,260,-612,1274,-2593,7000,12966,-2510,918,-321,83,-6,-7,3},
+	{-3,22,-90,260,-612,1271,-2578,6923,13020,-2491,905,-313,79,-4,-8,3},
+	{-3,22,-90,260,-611,1266,-2563,6845,13073,-2470,892,-305,75,-2,-8,3},
+	{-3,23,-91,260,-610,1262,-2548,6768,13127,-2449,878,-298,71,-1,-9,4},
+	{-3,23,-91,260,-609,1258,-2532,6691,13177,-2428,865,-290,67,1,-9,4},
+	{-3,23,-91,261,-608,1253,-2517,6613,13230,-2406,851,-282,63,3,-10,4},
+	{-3,23,-91,261,-607,1248,-2501,6536,13282,-2384,837,-274,59,5,-11,4},
+	{-3,23,-91,260,-606,1244,-2484,6458,13332,-2361,823,-266,55,7,-11,4},
+	{-3,23,-91,260,-605,1239,-2468,6381,13383,-2337,809,-258,51,8,-12,4},
+	{-3,23,-91,260,-603,1233,-2451,6304,13435,-2314,794,-250,46,10,-13,4},
+	{-3,23,-92,260,-602,1228,-2434,6226,13482,-2289,780,-241,42,12,-13,5},
+	{-3,23,-92,260,-600,1223,-2417,6149,13530,-2264,765,-233,38,14,-14,5},
+	{-3,23,-92,260,-599,1217,-2400,6072,13579,-2239,750,-225,34,16,-14,5},
+	{-3,23,-92,259,-597,1211,-2382,5995,13628,-2213,735,-216,29,17,-15,5},
+	{-3,23,-92,259,-595,1205,-2364,5918,13675,-2187,719,-207,25,19,-16,5},
+	{-3,23,-92,259,-594,1199,-2346,5841,13721,-2160,704,-199,21,21,-16,5},
+	{-3,23,-92,258,-592,1193,-2328,5764,13769,-2133,688,-190,16,23,-17,5},
+	{-3,23,-92,258,-590,1187,-2309,5687,13812,-2105,672,-181,12,25,-18,6},
+	{-3,23,-92,258,-588,1181,-2290,5610,13855,-2076,656,-172,7,27,-18,6},
+	{-3,23,-92,257,-586,1174,-2271,5533,13902,-2048,639,-163,3,29,-19,6},
+	{-3,23,-92,257,-584,1167,-2252,5457,13945,-2018,623,-154,-2,31,-20,6},
+	{-3,23,-92,256,-581,1161,-2233,5380,13988,-1989,606,-145,-6,33,-20,6},
+	{-3,23,-91,255,-579,1154,-2213,5304,14030,-1958,589,-136,-11,35,-21,6},
+	{-3,23,-91,255,-577,1147,-2194,5227,14073,-1927,572,-127,-15,37,-22,6},
+	{-3,23,-91,254,-574,1139,-2174,5151,14113,-1896,555,-117,-20,39,-22,7},
+	{-3,23,-91,254,-572,1132,-2154,5075,14155,-1864,537,-108,-25,41,-23,7},
+	{-3,23,-91,253,-569,1125,-2133,4999,14193,-1832,520,-98,-29,43,-24,7},
+	{-3,23,-91,252,-567,1117,-2113,4923,14235,-1799,502,-89,-34,45,-24,7},
+	{-3,23,-91,251,-564,1110,-2092,4848,14273,-1766,484,-79,-39,47,-25,7},
+	{-3,23,-91,251,-561,1102,-2072,4772,14312,-1732,466,-69,-44,49,-26,7},
+	{-3,23,-90,250,-558,1094,-2051,4697,14347,-1698,448,-60,-48,51,-26,8},
+	{-3,23,-90,249,-556,1086,-2030,4622,14386,-1663,429,-50,-53,53,-27,8},
+	{-3,23,-90,248,-553,1078,-2008,4546,14423,-1628,411,-40,-58,55,-28,8},
+	{-3,23,-90,247,-550,1070,-1987,4471,14459,-1592,392,-30,-63,57,-28,8},
+	{-3,23,-90,246,-547,1061,-1965,4397,14494,-1555,373,-20,-68,59,-29,8},
+	{-3,23,-89,245,-543,1053,-1944,4322,14529,-1519,354,-10,-73,61,-30,8},
+	{-3,23,-89,244,-540,1045,-1922,4248,14561,-1481,335,0,-78,63,-31,9},
+	{-3,23,-89,243,-537,1036,-1900,4174,14595,-1444,315,10,-82,65,-31,9},
+	{-3,23,-88,242,-534,1027,-1878,4100,14626,-1405,296,21,-87,67,-32,9},
+	{-3,23,-88,241,-530,1018,-1856,4026,14660,-1367,276,31,-92,69,-33,9},
+	{-3,23,-88,240,-527,1010,-1833,3952,14690,-1327,256,41,-97,71,-33,9},
+	{-3,23,-88,238,-523,1001,-1811,3879,14722,-1288,236,52,-102,73,-34,9},
+	{-3,23,-87,237,-520,992,-1788,3805,14750,-1247,216,62,-107,76,-35,10},
+	{-3,22,-87,236,-516,982,-1766,3732,14781,-1207,196,73,-112,78,-35,10},
+	{-2,22,-87,235,-513,973,-1743,3660,14810,-1166,175,83,-117,80,-36,10},
+	{-2,22,-86,234,-509,964,-1720,3587,14837,-1124,155,94,-123,82,-37,10},
+	{-2,22,-86,232,-505,954,-1697,3515,14867,-1082,134,104,-128,84,-38,10},
+	{-2,22,-85,231,-502,945,-1674,3443,14892,-1039,113,115,-133,86,-38,10},
+	{-2,22,-85,230,-498,935,-1650,3371,14917,-996,92,126,-138,88,-39,11},
+	{-2,22,-85,228,-494,926,-1627,3299,14943,-952,71,137,-143,90,-40,11},
+	{-2,22,-84,227,-490,916,-1604,3228,14968,-908,50,147,-148,92,-41,11},
+	{-2,22,-84,225,-486,906,-1580,3157,14992,-864,28,158,-153,95,-41,11},
+	{-2,22,-83,224,-482,896,-1557,3086,15015,-819,7,169,-158,97,-42,11},
+	{-2,22,-83,223,-478,886,-1533,3015,15038,-773,-15,180,-164,99,-43,12},
+	{-2,21,-83,221,-474,876,-1509,2945,15060,-727,-36,191,-169,101,-43,12},
+	{-2,21,-82,220,-470,866,-1486,2875,15082,-681,-58,202,-174,103,-44,12},
+	{-2,21,-82,218,-465,856,-1462,2805,15103,-634,-80,213,-179,105,-45,12},
+	{-2,21,-81,216,-461,846,-1438,2736,15122,-586,-102,224,-184,107,-46,12},
+	{-2,21,-81,215,-457,835,-1414,2666,15144,-539,-125,235,-190,110,-46,12},
+	{-2,21,-80,213,-453,825,-1390,2598,15160,-490,-147,246,-195,112,-47,13},
+	{-2,21,-80,212,-448,815,-1366,2529,15177,-441,-169,257,-200,114,-48,13},
+	{-2,21,-79,210,-444,804,-1342,2461,15194,-392,-192,269,-205,116,-48,13},
+	{-2,20,-79,208,-439,794,-1317,2393,15211,-342,-215,280,-210,118,-49,13},
+	{-2,20,-78,207,-435,783,-1293,2325,15228,-292,-237,291,-216,120,-50,13},
+	{-2,20,-78,205,-430,772,-1269,2258,15245,-242,-260,302,-221,122,-51,13},
+	{-2,20,-77,203,-426,762,-1245,2190,15258,-191,-283,313,-226,125,-51,14},
+	{-2,20,-77,202,-421,751,-1220,2124,15269,-139,-306,325,-231,127,-52,14},
+	{-2,20,-76,200,-417,740,-1196,2057,15284,-87,-329,336,-236,129,-53,14},
+	{-2,20,-75,198,-412,729,-1172,1991,15297,-35,-352,347,-242,131,-53,14},
+	{-2,20,-75,196,-407,719,-1147,1925,15308,18,-376,359,-247,133,-54,14},
+	{-2,19,-74,195,-403,708,-1123,1860,15319,71,-399,370,-252,135,-55,15},
+	{-2,19,-74,193,-398,697,-1098,1795,15329,125,-422,381,-257,137,-56,15},
+	{-2,19,-73,191,-393,686,-1074,1730,15338,179,-446,393,-262,139,-56,15},
+	{-2,19,-73,189,-388,675,-1050,1666,15348,234,-469,404,-268,141,-57,15},
+	{-2,19,-72,187,-384,664,-1025,1602,15357,289,-493,415,-273,143,-58,15},
+	{-2,19,-71,185,-379,653,-1001,1538,15363,344,-517,427,-278,146,-58,15},
+	{-2,19,-71,183,-374,641,-976,1475,15370,400,-541,438,-283,148,-59,16},
+	{-2,18,-70,182,-369,630,-952,1412,15376,456,-564,449,-288,150,-60,16},
+	{-2,18,-70,180,-364,619,-927,1349,15381,513,-588,461,-294,152,-60,16},
+	{-2,18,-69,178,-359,608,-903,1287,15386,570,-612,472,-299,154,-61,16},
+	{-2,18,-68,176,-354,597,-879,1225,15389,628,-636,484,-304,156,-62,16},
+	{-2,18,-68,174,-349,585,-854,1164,15392,686,-660,495,-309,158,-62,16},
+	{-2,18,-67,172,-344,574,-830,1102,15395,744,-684,506,-314,160,-63,17},
+	{-2,17,-66,170,-339,563,-806,1042,15397,803,-709,518,-319,162,-64,17},
+	{-2,17,-66,168,-334,552,-781,981,15398,862,-733,529,-324,164,-64,17},
+};
+
+#endif /* UTILS_LOOKUPS_H */
@@ -12,202 +12,199 @@
 
 #define FOUR_CC(a,b,c,d) (((a)<<24) | ((b)<<16) | ((c)<<8) | ((d)<<0))
 
+#define WR_HEADER_SIZE 512 // one sector, usually holds all chunks up to the data
+#define WR_FMT_MAX_SIZE 40 // WAVE_FORMAT_EXTENSIBLE
+#define WR_CLM_MAX_SIZE 16
+#define WR_DECODE_BUFFER_SIZE 256
+
+#define WAVE_FORMAT_PCM 1
+#define WAVE_FORMAT_IEEE_FLOAT 3
+#define WAVE_FORMAT_EXTENSIBLE 0xfffe
+
 static int
-read_byte(FIL *fp, unsigned char *out)
+get_int16_l(const unsigned char *p)
 {
-	unsigned int red = 0;
-	
-	f_read(fp, out, 1, &red);
-	
-    if (1 > red) {
-        return f_eof(fp) ? 0 : -1;
-    }
-	
-    return 1;
+    return (p[1]<<8) | (p[0]<<0);
 }
 
 static int
-read_int32_b(FIL *fp, int *out)
+get_int32_l(const unsigned char *p)
 {
-    int result;
-    unsigned char a, b, c, d;
-
-    if ((result=read_byte(fp, &a)) != 1) return result;
-    if ((result=read_byte(fp, &b)) != 1) return result;
-    if ((result=read_byte(fp, &c)) != 1) return result;
-    if ((result=read_byte(fp, &d)) != 1) return result;
-
-    *out = (a<<24) | (b<<16) | (c<<8) | (d<<0);
-    return 1;
+    return (p[3]<<24) | (p[2]<<16) | (p[1]<<8) | (p[0]<<0);
 }
 
 static int
-read_int32_l(FIL *fp, int *out)
+get_int32_b(const unsigned char *p)
 {
-    int result;
-    unsigned char a, b, c, d;
-
-    if ((result=read_byte(fp, &a)) != 1) return result;
-    if ((result=read_byte(fp, &b)) != 1) return result;
-    if ((result=read_byte(fp, &c)) != 1) return result;
-    if ((result=read_byte(fp, &d)) != 1) return result;
-
-    *out = (d<<24) | (c<<16) | (b<<8) | (a<<0);
-    return 1;
+    return (p[0]<<24) | (p[1]<<16) | (p[2]<<8) | (p[3]<<0);
 }
 
+// reads from the header buffer when possible, from the file otherwise
 static int
-read_int16_l(FIL *fp, int *out)
+read_at(struct wave_reader *wr, const unsigned char *header, unsigned int header_len, DWORD pos, void *out, unsigned int len)
 {
-    int result;
-    unsigned char a, b;
+	unsigned int red = 0;
 
-    if ((result=read_byte(fp, &a)) != 1) return result;
-    if ((result=read_byte(fp, &b)) != 1) return result;
+    if (pos + len <= header_len) {
+        memcpy(out, &header[pos], len);
+        return 1;
+    }
 
-    *out = (b<<8) | (a<<0);
-    return 1;
+    if (f_lseek(&wr->fp, pos) || f_read(&wr->fp, out, len, &red)) {
+        return -1;
+    }
+
+    return red == len ? 1 : 0;
 }
 
 static int
-read_wave_chunk(struct wave_reader *wr, wave_reader_error *error)
+read_fmt_chunk(struct wave_reader *wr, const unsigned char *header, unsigned int header_len, DWORD pos, DWORD len, wave_reader_error *error)
 {
     int result;
-    int sub1_id, sub1_len, sub2_id, sub2_len, byte_rate, block_align;
-
-    if ((result=read_int32_b(&wr->fp, &sub1_id)) != 1) {
-        *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
-        return 0;
-    }
+    unsigned char fmt[WR_FMT_MAX_SIZE];
 
-    if (sub1_id != FOUR_CC('f','m','t',' ')) {
+    if (len < 16) {
         *error = WR_BAD_CONTENT;
         return 0;
     }
 
-    if ((result=read_int32_l(&wr->fp, &sub1_len)) != 1) {
-        *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
-        return 0;
-    }
+    len = len < sizeof(fmt) ? len : sizeof(fmt);
 
-    if ((result=read_int16_l(&wr->fp, &wr->format)) != 1) {
+    if ((result=read_at(wr, header, header_len, pos, fmt, len)) != 1) {
         *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
         return 0;
     }
 
-    if ((result=read_int16_l(&wr->fp, &wr->num_channels)) != 1) {
-        *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
-        return 0;
-    }
+    wr->format = get_int16_l(&fmt[0]);
+    wr->num_channels = get_int16_l(&fmt[2]);
+    wr->sample_rate = get_int32_l(&fmt[4]);
+    wr->block_align = get_int16_l(&fmt[12]);
+    wr->sample_bits = get_int16_l(&fmt[14]);
 
-    if ((result=read_int32_l(&wr->fp, &wr->sample_rate)) != 1) {
-        *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
-        return 0;
-    }
-
-    if ((result=read_int32_l(&wr->fp, &byte_rate)) != 1) {
-        *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
-        return 0;
+    if (wr->format == WAVE_FORMAT_EXTENSIBLE && len >= 26) {
+        wr->format = get_int16_l(&fmt[24]); // first bytes of SubFormat GUID
     }
 
-    if ((result=read_int16_l(&wr->fp, &block_align)) != 1) {
-        *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
-        return 0;
-    }
+    wr->sample_format = WR_SF_UNSUPPORTED;
 
-    if ((result=read_int16_l(&wr->fp, &wr->sample_bits)) != 1) {
-        *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
-        return 0;
+    if (wr->num_channels < 1 || wr->block_align != wr->num_channels * wr->sample_bits / 8) {
+        return 1;
     }
 
-    if ((result=read_int32_b(&wr->fp, &sub2_id)) != 1) {
-        *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
-        return 0;
-    }
-
-    if (sub2_id != FOUR_CC('d','a','t','a')) {
-        *error = WR_BAD_CONTENT;
-        return 0;
-    }
-
-    if ((result=read_int32_l(&wr->fp, &sub2_len)) != 1) {
-        *error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
-        return 0;
+    if (wr->format == WAVE_FORMAT_PCM) {
+        switch (wr->sample_bits) {
+        case 8: wr->sample_format = WR_SF_U8; break;
+        case 16: wr->sample_format = WR_SF_S16; break;
+        case 24: wr->sample_format = WR_SF_S24; break;
+        case 32: wr->sample_format = WR_SF_S32; break;
+        }
+    } else if (wr->format == WAVE_FORMAT_IEEE_FLOAT && wr->sample_bits == 32) {
+        wr->sample_format = WR_SF_F32;
     }
 
-    wr->num_samples = sub2_len / (wr->num_channels * wr->sample_bits / 8);
-
     return 1;
 }
 
-static int
-skip(struct wave_reader *wr, wave_reader_error *error)
+// wavetable frame size, "<!>2048 ..." in Serum-style "clm " chunks
+static void
+read_clm_chunk(struct wave_reader *wr, const unsigned char *header, unsigned int header_len, DWORD pos, DWORD len)
 {
-    int len;
+    unsigned char clm[WR_CLM_MAX_SIZE];
+    unsigned int i;
+    int frame_size = 0;
 
-    if (!read_int32_l(&wr->fp, &len)) {
-        *error = WR_IO_ERROR;
-        return 0;
+    len = len < sizeof(clm) ? len : sizeof(clm);
+
+    if (len < 4 || read_at(wr, header, header_len, pos, clm, len) != 1 || memcmp(clm, "<!>", 3)) {
+        return;
     }
 
-    if (f_lseek(&wr->fp, f_tell(&wr->fp) + len)) {
-        *error = WR_IO_ERROR;
-        return 0;
+    for (i = 3; i < len && clm[i] >= '0' && clm[i] <= '9'; ++i) {
+        frame_size = frame_size * 10 + clm[i] - '0';
     }
 
-    return 1;
+    wr->frame_size = frame_size;
 }
 
 wave_reader_error
 wave_reader_open(const char *filename, struct wave_reader *wr)
 {
-    int root_id, root_len, format_id;
-    int continue_reading = 1;
+    unsigned char header[WR_HEADER_SIZE];
+    unsigned char chunk[8];
+    unsigned int header_len = 0;
+    DWORD pos, len;
+    int result, have_fmt = 0;
 	wave_reader_error error = WR_NO_ERROR;
 
     assert(filename != NULL);
+    assert(wr != NULL);
+
+    memset(wr, 0, sizeof(*wr));
 
     if (f_open(&wr->fp, filename, FA_READ | FA_OPEN_EXISTING)) {
         error = WR_OPEN_ERROR;
         goto open_error;
     }
 
-    if (!read_int32_b(&wr->fp, &root_id)) {
+    if (f_read(&wr->fp, header, sizeof(header), &header_len)) {
         error = WR_IO_ERROR;
         goto reading_error;
     }
 
-    if (root_id != FOUR_CC('R','I','F','F')) {
+    if (header_len < 12 || get_int32_b(&header[0]) != FOUR_CC('R','I','F','F') || get_int32_b(&header[8]) != FOUR_CC('W','A','V','E')) {
         error = WR_BAD_CONTENT;
         goto reading_error;
     }
 
-    if (!read_int32_l(&wr->fp, &root_len)) {
-        error = WR_IO_ERROR;
-        goto reading_error;
-    }
+    // walk chunks until data, skipping the ones we don't know (LIST, fact, cue , ...)
 
-    while (continue_reading) {
-        if (!read_int32_b(&wr->fp, &format_id)) {
-            error = WR_IO_ERROR;
+    pos = 12;
+    for (;;) {
+        if ((result=read_at(wr, header, header_len, pos, chunk, sizeof(chunk))) != 1) {
+            error = result == 0 ? WR_BAD_CONTENT : WR_IO_ERROR;
             goto reading_error;
         }
 
-        switch (format_id) {
-        case FOUR_CC('W','A','V','E'):
-            if (!read_wave_chunk(wr, &error)) {
+        len = get_int32_l(&chunk[4]);
+        pos += sizeof(chunk);
+
+        switch (get_int32_b(&chunk[0])) {
+        case FOUR_CC('f','m','t',' '):
+            if (!read_fmt_chunk(wr, header, header_len, pos, len, &error)) {
                 goto reading_error;
             }
-            continue_reading = 0;
+            have_fmt = 1;
             break;
-        default:
-            if (!skip(wr, &error)) {
+        case FOUR_CC('c','l','m',' '):
+            read_clm_chunk(wr, header, header_len, pos, len);
+            break;
+        case FOUR_CC('d','a','t','a'):
+            if (!have_fmt || wr->block_align <= 0) {
+                error = WR_BAD_CONTENT;
                 goto reading_error;
             }
+
+            if (len > f_size(&wr->fp) - pos) { // some writers leave it unset
+                len = f_size(&wr->fp) - pos;
+            }
+
+            wr->num_samples = len / wr->block_align;
+
+            if (f_lseek(&wr->fp, pos)) {
+                error = WR_IO_ERROR;
+                goto reading_error;
+            }
+
+            return WR_NO_ERROR;
         }
-    }
 
-    return error;
+        if (len >= f_size(&wr->fp) - pos) { // no data chunk
+            error = WR_BAD_CONTENT;
+            goto reading_error;
+        }
+
+        pos += len + (len & 1); // chunks are word aligned
+    }
 
 reading_error:
     f_close(&wr->fp);
@@ -264,6 +261,22 @@ wave_reader_get_num_samples(struct wave_reader *wr)
     return wr->num_samples;
 }
 
+wave_reader_sample_format
+wave_reader_get_sample_format(struct wave_reader *wr)
+{
+    assert(wr != NULL);
+
+    return wr->sample_format;
+}
+
+int
+wave_reader_get_frame_size(struct wave_reader *wr)
+{
+    assert(wr != NULL);
+
+    return wr->frame_size;
+}
+
 int
 wave_reader_get_samples(struct wave_reader *wr, int n, void *buf)
 {
@@ -281,3 +294,61 @@ wave_reader_get_samples(struct wave_reader *wr, int n, void *buf)
     return ret;
 }
 
+int
+wave_reader_get_samples_int16(struct wave_reader *wr, int n, int16_t *buf)
+{
+    unsigned char tmp[WR_DECODE_BUFFER_SIZE];
+	unsigned int red = 0;
+    int i, cnt, bytes, count;
+    const unsigned char *p;
+    float f;
+
+    assert(wr != NULL);
+    assert(buf != NULL);
+
+    switch (wr->sample_format) {
+    case WR_SF_UNSUPPORTED:
+        return -1;
+    case WR_SF_S16:
+        return wave_reader_get_samples(wr, n, buf);
+    default:
+        break;
+    }
+
+    bytes = wr->sample_bits / 8;
+    count = n * wr->num_channels;
+
+    while (count > 0) {
+        cnt = sizeof(tmp) / bytes;
+        cnt = count < cnt ? count : cnt;
+
+        if (f_read(&wr->fp, tmp, cnt * bytes, &red)) {
+            return -1;
+        }
+
+        for (i = 0, p = tmp; i < cnt; ++i, p += bytes) {
+            switch (wr->sample_format) {
+            case WR_SF_U8:
+                *buf++ = (p[0] - 128) << 8;
+                break;
+            case WR_SF_S24:
+                *buf++ = (p[2]<<8) | p[1];
+                break;
+            case WR_SF_S32:
+                *buf++ = (p[3]<<8) | p[2];
+                break;
+            case WR_SF_F32:
+                memcpy(&f, p, sizeof(f));
+                f *= 32768.0f;
+                *buf++ = f >= 32767.0f ? 32767 : (f <= -32768.0f ? -32768 : (int16_t)f);
+                break;
+            default:
+                break;
+            }
+        }
+
+        count -= cnt;
+    }
+
+    return 0;
+}
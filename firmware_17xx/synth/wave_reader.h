@@ -1,6 +1,7 @@
 #ifndef WAVE_READER_H
 #define WAVE_READER_H
 
+#include <stdint.h>
 #include "ff.h"
 
 typedef enum {
@@ -10,12 +11,24 @@ typedef enum {
     WR_BAD_CONTENT,
 } wave_reader_error;
 
+typedef enum {
+    WR_SF_UNSUPPORTED = 0,
+    WR_SF_U8,
+    WR_SF_S16,
+    WR_SF_S24,
+    WR_SF_S32,
+    WR_SF_F32,
+} wave_reader_sample_format;
+
 typedef struct wave_reader {
     int format;
     int num_channels;
     int sample_rate;
     int sample_bits;
     int num_samples;
+    int block_align;
+    int frame_size; // wavetable frame size from "clm " chunk, 0 when unknown
+    wave_reader_sample_format sample_format;
     FIL fp;
 } wave_reader;
 
@@ -26,7 +39,10 @@ int wave_reader_get_num_channels(wave_reader *wr);
 int wave_reader_get_sample_rate(wave_reader *wr);
 int wave_reader_get_sample_bits(wave_reader *wr);
 int wave_reader_get_num_samples(wave_reader *wr);
-int wave_reader_get_samples(wave_reader *wr, int n, void *buf);
+wave_reader_sample_format wave_reader_get_sample_format(wave_reader *wr);
+int wave_reader_get_frame_size(wave_reader *wr);
+int wave_reader_get_samples(wave_reader *wr, int n, void *buf); // raw
+int wave_reader_get_samples_int16(wave_reader *wr, int n, int16_t *buf); // any supported sample format
 
 #endif//WAVE_READER_H
 
@@ -13,6 +13,11 @@
 
 #define WIDTH_MOD_BITS 14
 #define FRAC_SHIFT 12
+#define AMP_FRAC_SHIFT 8
+#define AMP_UNITY (1<<16)
+#define AMP_RAMP_SHIFT 4 // log2 of samples per update
+
+_Static_assert(DACSPI_BUFFER_COUNT/4==1<<AMP_RAMP_SHIFT,"wtosc_update() is called with DACSPI_BUFFER_COUNT/4 samples");
 
 static FORCEINLINE uint32_t cvToFrequency(uint32_t cv) // returns the frequency shifted by 8
 {
@@ -26,6 +31,18 @@ static FORCEINLINE uint32_t cvToFrequency(uint32_t cv) // returns the frequency
 	return v;
 }
 
+static FORCEINLINE uint16_t applyAmplitude(struct wtosc_s * o, uint16_t r)
+{
+	// VCA mode, or digital envelope sustaining at full level
+	if(o->ampUnity)
+		return r;
+	
+	// amplitude ramps linearly to its target over one update
+	o->amplitude+=o->ampIncrement;
+	
+	return HALF_RANGE+((((int32_t)r-HALF_RANGE)*(o->amplitude>>AMP_FRAC_SHIFT))>>16);
+}
+
 static FORCEINLINE void updatePeriodIncrement(struct wtosc_s * o, int8_t type)
 {
 	if(o->pendingUpdate>=type)
@@ -39,6 +56,16 @@ static FORCEINLINE void updatePeriodIncrement(struct wtosc_s * o, int8_t type)
 	}
 }
 
+static FORCEINLINE void updateSampleData(struct wtosc_s * o)
+{
+	if(o->pendingMainData)
+	{
+		o->mainData=o->pendingMainData;
+		o->crossoverData=o->pendingCrossoverData;
+		o->pendingMainData=NULL;
+	}
+}
+
 static FORCEINLINE void handlePhaseUnderflow(struct wtosc_s * o, int32_t bufIdx, oscSyncMode_t syncMode, int16_t * syncPositions)
 {
 	if(o->phase<0)
@@ -46,6 +73,7 @@ static FORCEINLINE void handlePhaseUnderflow(struct wtosc_s * o, int32_t bufIdx,
 		o->phase+=WTOSC_SAMPLE_COUNT;
 
 		updatePeriodIncrement(o,1);
+		updateSampleData(o);
 	
 		// sync (master side)
 		if(syncMode==osmMaster)
@@ -279,7 +307,7 @@ static FORCEINLINE void update_slaveSync_wmOff(struct wtosc_s * o, int32_t start
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -315,7 +343,7 @@ static FORCEINLINE void update_slaveSync_wmWidth(struct wtosc_s * o, int32_t sta
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -350,7 +378,7 @@ static FORCEINLINE void update_slaveSync_wmAliasing(struct wtosc_s * o, int32_t
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -385,7 +413,7 @@ static FORCEINLINE void update_slaveSync_wmCrossOver(struct wtosc_s * o, int32_t
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -420,7 +448,7 @@ static FORCEINLINE void update_slaveSync_wmFolder(struct wtosc_s * o, int32_t st
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -455,7 +483,7 @@ static FORCEINLINE void update_slaveSync_wmBitCrush(struct wtosc_s * o, int32_t
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -509,7 +537,7 @@ static FORCEINLINE void update_masterSync_wmOff(struct wtosc_s * o, int32_t star
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -545,7 +573,7 @@ static FORCEINLINE void update_masterSync_wmWidth(struct wtosc_s * o, int32_t st
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -580,7 +608,7 @@ static FORCEINLINE void update_masterSync_wmAliasing(struct wtosc_s * o, int32_t
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -615,7 +643,7 @@ static FORCEINLINE void update_masterSync_wmCrossOver(struct wtosc_s * o, int32_
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -650,7 +678,7 @@ static FORCEINLINE void update_masterSync_wmFolder(struct wtosc_s * o, int32_t s
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -685,7 +713,7 @@ static FORCEINLINE void update_masterSync_wmBitCrush(struct wtosc_s * o, int32_t
 
 		// send value to DAC
 
-		dacspi_setOscValue(buf,o->channel,r);
+		dacspi_setOscValue(buf,o->channel,applyAmplitude(o,r));
 	}
 }
 
@@ -694,16 +722,51 @@ void wtosc_init(struct wtosc_s * o, int8_t channel)
 	memset(o,0,sizeof(struct wtosc_s));
 
 	o->channel=channel;
+	o->ampTarget=AMP_UNITY;
+	o->amplitude=AMP_UNITY<<AMP_FRAC_SHIFT;
+	o->ampUnity=1;
 	
 	wtosc_setSampleData(o,NULL,NULL);
 	wtosc_setParameters(o,MIDDLE_C_NOTE*WTOSC_CV_SEMITONE,wmOff,HALF_RANGE);
 	updatePeriodIncrement(o,1);
 }
 
+FORCEINLINE void wtosc_setAmplitude(struct wtosc_s * o, uint16_t amplitude)
+{
+	o->ampTarget=amplitude+(amplitude>>15); // 65535 -> unity
+}
+
 FORCEINLINE void wtosc_setSampleData(struct wtosc_s * o, uint16_t * mainData, uint16_t * xovrData)
 {
-	o->mainData=mainData;
-	o->crossoverData=xovrData;
+	// the DMA IRQ swaps pending data in, the pair must not be seen half written
+	BLOCK_INT(1)
+	{
+		if(o->mainData && mainData)
+		{
+			// swapping tables mid cycle would click, wait for the cycle start
+			o->pendingCrossoverData=xovrData;
+			o->pendingMainData=(mainData!=o->mainData || xovrData!=o->crossoverData)?mainData:NULL;
+		}
+		else
+		{
+			o->pendingMainData=NULL;
+			o->mainData=mainData;
+			o->crossoverData=xovrData;
+		}
+	}
+}
+
+int8_t wtosc_isSampleDataUsed(struct wtosc_s * o, uint16_t * data)
+{
+	int8_t used;
+	
+	// a swap between the reads would hide data moving from pending to current
+	BLOCK_INT(1)
+	{
+		used=o->mainData==data || o->crossoverData==data || (o->pendingMainData && (o->pendingMainData==data || o->pendingCrossoverData==data));
+	}
+	
+	return used;
 }
 
 FORCEINLINE void wtosc_setParameters(struct wtosc_s * o, uint16_t pitch, oscWModTarget_t wmType, uint16_t wmAmount)
@@ -821,7 +884,12 @@ void wtosc_update(struct wtosc_s * o, int32_t startBuffer, int32_t endBuffer, os
 	
 	updatePeriodIncrement(o,2);
 	
+	o->ampIncrement=((o->ampTarget<<AMP_FRAC_SHIFT)-o->amplitude)>>AMP_RAMP_SHIFT;
+	o->ampUnity=!o->ampIncrement && o->ampTarget==AMP_UNITY;
+	
 	uint8_t mode=(o->wmType<<2)|((syncMode==osmSlave?1:0)<<1)|(o->mainData?1:0);
 
 	update[mode](o,startBuffer,endBuffer,syncMode,syncPositions);
+	
+	o->amplitude=o->ampTarget<<AMP_FRAC_SHIFT; // no rounding errors accumulation
 }
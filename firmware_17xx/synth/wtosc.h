@@ -20,6 +20,8 @@ struct wtosc_s
 {
 	uint16_t * mainData;
 	uint16_t * crossoverData;
+	uint16_t * volatile pendingMainData; // swapped in at next cycle start, by the DMA IRQ
+	uint16_t * volatile pendingCrossoverData;
 	
 	int32_t period[2],pendingPeriod[2]; // one per waveform half
 	int32_t increment[2],pendingIncrement[2];
@@ -29,6 +31,8 @@ struct wtosc_s
 
 	int32_t curSample,prevSample,prevSample2,prevSample3;
 	
+	int32_t amplitude,ampIncrement,ampTarget; // digital amplitude, unity is 1<<16
+	
 	int32_t aliasing;
 	int32_t folder;
 	int32_t bitcrush;
@@ -39,6 +43,7 @@ struct wtosc_s
 	oscWModTarget_t wmType;
 	int8_t channel;
 	int8_t pendingUpdate;
+	int8_t ampUnity;
 };
 
 typedef enum
@@ -50,8 +55,11 @@ void wtosc_init(struct wtosc_s * o, int8_t channel);
 // data must be persistent and be filled with values in the range
 // WTOSC_SAMPLES_GUARD_BAND..65535-WTOSC_SAMPLES_GUARD_BAND
 // this is because hermite interpolation will overshoot on sharp transitions
+// when the oscillator already has data, the new one is only used from its next cycle start
 void wtosc_setSampleData(struct wtosc_s * o, uint16_t * mainData, uint16_t * xovrData);
+int8_t wtosc_isSampleDataUsed(struct wtosc_s * o, uint16_t * data);
 void wtosc_setParameters(struct wtosc_s * o, uint16_t pitch, oscWModTarget_t wmType, uint16_t wmAmount);
+void wtosc_setAmplitude(struct wtosc_s * o, uint16_t amplitude); // applied at sample rate, ramps over next update
 void wtosc_update(struct wtosc_s * o, int32_t startBuffer, int32_t endBuffer, oscSyncMode_t syncMode, int16_t *syncPositions);
 
 #endif
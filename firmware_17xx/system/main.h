@@ -40,11 +40,13 @@ static inline uint32_t __disable_irq_stub(uint32_t basepri)
 {
 	uint32_t pm=__get_BASEPRI();
 	__set_BASEPRI(basepri << (8 - __NVIC_PRIO_BITS));
+	asm volatile ("" ::: "memory"); // CMSIS MSR has no memory clobber, keep accesses inside the block
 	return pm;
 }
 
 static inline void __restore_irq_stub(uint32_t basepri)
 {
+	asm volatile ("" ::: "memory");
 	__set_BASEPRI(basepri);
 }
 
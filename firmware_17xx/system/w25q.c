@@ -1,4 +1,5 @@
 #include <time.h>
+#include <string.h>
 
 #include "w25q.h"
 
@@ -6,6 +7,8 @@
 #include "lpc177x_8x_gpio.h"
 #include "lpc177x_8x_ssp.h"
 #include "lpc177x_8x_pinsel.h"
+#include "lpc177x_8x_gpdma.h"
+#include "lpc177x_8x_clkpwr.h"
 #include "rprintf.h"
 
 #define CMD_WRITE_ENABLE 0x06
@@ -22,6 +25,30 @@
 
 #define STATUS_BUSY 1
 
+#define DMA_CHANNEL_SSP1_TX__T2_MAT_0 4
+#define DMA_CHANNEL_SSP1_RX__T2_MAT_1 5
+
+#define DMA_MAX_TRANSFER 2048 // GPDMA transfer size is 12 bits, sectors are sent in 2 LLIs
+
+// receive has the higher priority, so that the Rx FIFO can't overflow
+#define DMACH_RX LPC_GPDMACH2
+#define DMACH_RX_MASK (1<<2)
+#define DMACH_TX LPC_GPDMACH3
+#define DMACH_TX_MASK (1<<3)
+
+// SSP1 Tx DMA request is shared with timer 2 match 0, which paces the pots scan (channel 1)
+#define DMACH_SHARED LPC_GPDMACH1
+
+static EXT_RAM GPDMA_LLI_Type rxLli,txLli;
+static EXT_RAM uint8_t rxDummy,txDummy;
+
+// sequential reads continue the same FAST_READ command, CS stays low in between
+static struct
+{
+	int8_t open;
+	uint32_t nextIndex;
+} readStream;
+
 static inline void csSet(uint32_t dummy)
 {
 	GPIO_OutputValue(0,1<<6,1);
@@ -31,6 +58,13 @@ static inline void csSet(uint32_t dummy)
 
 static inline uint32_t csClear(void)
 {
+	// any new command ends the pending read
+	if(readStream.open)
+	{
+		readStream.open=0;
+		csSet(0);
+	}
+	
 	GPIO_OutputValue(0,1<<6,0);
 	
 	DELAY_50NS();
@@ -58,6 +92,83 @@ static uint8_t sendRead8(uint8_t value)
 	return res;
 }
 
+// transfers size bytes, NULL tx sends zeroes, NULL rx discards received data
+static void dmaTransfer(const uint8_t * tx, uint8_t * rx, int size)
+{
+	uint32_t reqSel,rxCtl,txCtl;
+	int first=(size>DMA_MAX_TRANSFER)?DMA_MAX_TRANSFER:size;
+	int rest=size-first;
+	
+	rxCtl=GPDMA_DMACCxControl_SWidth(0)|GPDMA_DMACCxControl_DWidth(0)|(rx?GPDMA_DMACCxControl_DI:0);
+	txCtl=GPDMA_DMACCxControl_SWidth(0)|GPDMA_DMACCxControl_DWidth(0)|(tx?GPDMA_DMACCxControl_SI:0);
+	
+	if(!rx)
+		rx=&rxDummy;
+	if(!tx)
+	{
+		txDummy=0x00;
+		tx=&txDummy;
+	}
+	
+	rxLli.SrcAddr=(uint32_t)&LPC_SSP1->DR;
+	rxLli.DstAddr=(uint32_t)rx+((rxCtl&GPDMA_DMACCxControl_DI)?first:0);
+	rxLli.NextLLI=0;
+	rxLli.Control=rxCtl|GPDMA_DMACCxControl_TransferSize(rest)|GPDMA_DMACCxControl_I;
+
+	txLli.SrcAddr=(uint32_t)tx+((txCtl&GPDMA_DMACCxControl_SI)?first:0);
+	txLli.DstAddr=(uint32_t)&LPC_SSP1->DR;
+	txLli.NextLLI=0;
+	txLli.Control=txCtl|GPDMA_DMACCxControl_TransferSize(rest);
+	
+	// pause the pots scan and take SSP1 Tx request back from the timer
+	
+	DMACH_SHARED->CConfig|=GPDMA_DMACCxConfig_H;
+	while(DMACH_SHARED->CConfig&GPDMA_DMACCxConfig_A);
+	
+	reqSel=LPC_SC->DMAREQSEL;
+	LPC_SC->DMAREQSEL=reqSel&~((1<<DMA_CHANNEL_SSP1_TX__T2_MAT_0)|(1<<DMA_CHANNEL_SSP1_RX__T2_MAT_1));
+	
+	LPC_GPDMA->IntTCClear=DMACH_RX_MASK|DMACH_TX_MASK;
+	LPC_GPDMA->IntErrClr=DMACH_RX_MASK|DMACH_TX_MASK;
+
+	DMACH_RX->CSrcAddr=(uint32_t)&LPC_SSP1->DR;
+	DMACH_RX->CDestAddr=(uint32_t)rx;
+	DMACH_RX->CLLI=rest?(uint32_t)&rxLli:0;
+	DMACH_RX->CControl=rxCtl|GPDMA_DMACCxControl_TransferSize(first)|(rest?0:GPDMA_DMACCxControl_I);
+	
+	DMACH_TX->CSrcAddr=(uint32_t)tx;
+	DMACH_TX->CDestAddr=(uint32_t)&LPC_SSP1->DR;
+	DMACH_TX->CLLI=rest?(uint32_t)&txLli:0;
+	DMACH_TX->CControl=txCtl|GPDMA_DMACCxControl_TransferSize(first);
+
+	// no ITC, completion is read from raw status, the DMA interrupt belongs to the DACs
+	DMACH_RX->CConfig=GPDMA_DMACCxConfig_E|GPDMA_DMACCxConfig_SrcPeripheral(DMA_CHANNEL_SSP1_RX__T2_MAT_1)|GPDMA_DMACCxConfig_TransferType(2);
+	DMACH_TX->CConfig=GPDMA_DMACCxConfig_E|GPDMA_DMACCxConfig_DestPeripheral(DMA_CHANNEL_SSP1_TX__T2_MAT_0)|GPDMA_DMACCxConfig_TransferType(1);
+	
+	LPC_SSP1->DMACR=SSP_DMA_TX|SSP_DMA_RX;
+	
+	// last byte received means last byte sent
+
+	while(!(LPC_GPDMA->RawIntTCStat&DMACH_RX_MASK))
+	{
+		if(LPC_GPDMA->RawIntErrStat&(DMACH_RX_MASK|DMACH_TX_MASK))
+		{
+			rprintf(0,"W25Q: DMA failure has occurred\n");
+			for(;;);
+		}
+	}
+	
+	LPC_SSP1->DMACR=0;
+	LPC_GPDMA->IntTCClear=DMACH_RX_MASK|DMACH_TX_MASK;
+	DMACH_RX->CConfig=0;
+	DMACH_TX->CConfig=0;
+
+	// resume the pots scan
+
+	LPC_SC->DMAREQSEL=reqSel;
+	DMACH_SHARED->CConfig&=~GPDMA_DMACCxConfig_H;
+}
+
 static void send32(uint32_t value)
 {
 	sendRead8((value>>24)&0xff);
@@ -106,27 +217,65 @@ static void reset(void)
 	waitBUSY();
 }
 
+void W25Q_readSectors(uint32_t index, uint32_t count, uint8_t * buffer)
+{
+	if(!readStream.open || readStream.nextIndex!=index)
+	{
+		csClear();
+		
+		sendRead8(CMD_FAST_READ);
+		send32(index<<W25Q_SECTOR_BITS);
+		sendRead8(0x00); // dummy byte		
+		
+		readStream.open=1;
+	}
+	
+	for(;count;--count)
+	{
+		dmaTransfer(NULL,buffer,W25Q_SECTOR_SIZE);
+		
+		buffer+=W25Q_SECTOR_SIZE;
+		++index;
+	}
+	
+	readStream.nextIndex=index;
+}
+
 void W25Q_readSector(uint32_t index, uint8_t * buffer)
+{
+	W25Q_readSectors(index,1,buffer);
+}
+
+void W25Q_read(uint32_t address, uint8_t * buffer, uint32_t size)
 {
 	HANDLE_CS
 	{
 		sendRead8(CMD_FAST_READ);
-		send32(index<<W25Q_SECTOR_BITS);
+		send32(address);
 		sendRead8(0x00); // dummy byte		
 		
-		for(int size=0;size<W25Q_SECTOR_SIZE;++size)
-		{
-			*buffer++=sendRead8(0x00);
-		}
+		dmaTransfer(NULL,buffer,size);
 	}
 }
 
-void W25Q_writeSector(uint32_t index, const uint8_t * buffer)
+void W25Q_program(uint32_t address, const uint8_t * buffer, uint32_t size)
 {
-	// erase sector
-	
 	enableWrites();
-	
+
+	HANDLE_CS
+	{
+		sendRead8(CMD_PAGE_PROGRAM);
+		send32(address);
+		dmaTransfer(buffer,NULL,size);
+	}
+
+	waitBUSY();
+}
+
+void W25Q_eraseSector(uint32_t index)
+{
+	enableWrites();
+
 	HANDLE_CS
 	{
 		sendRead8(CMD_SECTOR_ERASE);
@@ -134,27 +283,141 @@ void W25Q_writeSector(uint32_t index, const uint8_t * buffer)
 	}
 
 	waitBUSY();
+}
+
+uint32_t W25Q_compareSector(uint32_t index, const uint8_t * buffer)
+{
+	uint8_t page[W25Q_PAGE_SIZE];
+	uint32_t changed=0,used=0,erase=0;
+	
+	HANDLE_CS
+	{
+		sendRead8(CMD_FAST_READ);
+		send32(index<<W25Q_SECTOR_BITS);
+		sendRead8(0x00); // dummy byte		
+		
+		for(int p=0;p<W25Q_PAGES_PER_SECTOR;++p)
+		{
+			dmaTransfer(NULL,page,W25Q_PAGE_SIZE);
+			
+			for(int i=0;i<W25Q_PAGE_SIZE;++i)
+			{
+				uint8_t b=buffer[i];
+				
+				if(b!=0xff)
+					used|=1<<p;
+				
+				if(b!=page[i])
+				{
+					changed|=1<<p;
+					
+					// programming only clears bits
+					if(b&~page[i])
+						erase=W25Q_ERASE;
+				}
+			}
+			
+			buffer+=W25Q_PAGE_SIZE;
+		}
+	}
+	
+	// once erased, blank pages need no programming
+	return erase?(erase|used):changed;
+}
+
+void W25Q_programSector(uint32_t index, const uint8_t * buffer, uint32_t pages)
+{
+	if(pages&W25Q_ERASE)
+		W25Q_eraseSector(index);
 	
 	// program individual pages
 
-	for(int pageAddr=0;pageAddr<W25Q_SECTOR_SIZE;pageAddr+=W25Q_PAGE_SIZE)
+	for(int p=0;p<W25Q_PAGES_PER_SECTOR;++p)
+		if(pages&(1<<p))
+			W25Q_program((index<<W25Q_SECTOR_BITS)+(p<<W25Q_PAGE_BITS),&buffer[p<<W25Q_PAGE_BITS],W25Q_PAGE_SIZE);
+}
+
+void W25Q_writeSector(uint32_t index, const uint8_t * buffer)
+{
+	W25Q_programSector(index,buffer,W25Q_ERASE|W25Q_ALL_PAGES);
+}
+
+#ifdef DEBUG
+
+#define DWT_CTRL (*(volatile uint32_t *)0xe0001000)
+#define DWT_CYCCNT (*(volatile uint32_t *)0xe0001004)
+
+#define BENCHMARK_SECTORS 32
+#define BENCHMARK_PAGES 64
+
+static void printThroughput(const char * name, uint32_t bytes, uint32_t cycles)
+{
+	// rprintf has no float
+	rprintf(0,"W25Q: %s %d bytes %d cycles %d KB/s\n",name,bytes,cycles,
+			(uint32_t)(((uint64_t)bytes*SystemCoreClock)/(1024*(uint64_t)(cycles?cycles:1))));
+}
+
+// throughput of the polled (one SSP_ReadWrite call per byte) and GPDMA paths, scratch: one sector
+// programs are all 0xff, which leaves any flash content as is
+void W25Q_benchmark(uint8_t * scratch)
+{
+	uint32_t cycles;
+	int i,j;
+	
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+	DWT_CTRL|=1;
+	
+	cycles=DWT_CYCCNT;
+	for(i=0;i<BENCHMARK_SECTORS;++i)
+		HANDLE_CS
+		{
+			sendRead8(CMD_FAST_READ);
+			send32(i<<W25Q_SECTOR_BITS);
+			sendRead8(0x00); // dummy byte		
+
+			for(j=0;j<W25Q_SECTOR_SIZE;++j)
+				scratch[j]=sendRead8(0x00);
+		}
+	printThroughput("polled read",BENCHMARK_SECTORS*W25Q_SECTOR_SIZE,DWT_CYCCNT-cycles);
+	
+	cycles=DWT_CYCCNT;
+	for(i=0;i<BENCHMARK_SECTORS;++i)
+		W25Q_read(i<<W25Q_SECTOR_BITS,scratch,W25Q_SECTOR_SIZE);
+	printThroughput("DMA read",BENCHMARK_SECTORS*W25Q_SECTOR_SIZE,DWT_CYCCNT-cycles);
+
+	cycles=DWT_CYCCNT;
+	for(i=0;i<BENCHMARK_SECTORS;++i)
+		W25Q_readSectors(i,1,scratch);
+	printThroughput("DMA streamed read",BENCHMARK_SECTORS*W25Q_SECTOR_SIZE,DWT_CYCCNT-cycles);
+	
+	memset(scratch,0xff,W25Q_PAGE_SIZE);
+
+	cycles=DWT_CYCCNT;
+	for(i=0;i<BENCHMARK_PAGES;++i)
 	{
 		enableWrites();
-		
+
 		HANDLE_CS
 		{
 			sendRead8(CMD_PAGE_PROGRAM);
-			send32((index<<W25Q_SECTOR_BITS)+pageAddr);
-			for(int size=0;size<W25Q_PAGE_SIZE;++size)
-			{
-				sendRead8(*buffer++);
-			}
+			send32(i<<W25Q_PAGE_BITS);
+
+			for(j=0;j<W25Q_PAGE_SIZE;++j)
+				sendRead8(scratch[j]);
 		}
-		
+
 		waitBUSY();
 	}
+	printThroughput("polled program",BENCHMARK_PAGES*W25Q_PAGE_SIZE,DWT_CYCCNT-cycles);
+
+	cycles=DWT_CYCCNT;
+	for(i=0;i<BENCHMARK_PAGES;++i)
+		W25Q_program(i<<W25Q_PAGE_BITS,scratch,W25Q_PAGE_SIZE);
+	printThroughput("DMA program",BENCHMARK_PAGES*W25Q_PAGE_SIZE,DWT_CYCCNT-cycles);
 }
 
+#endif
+
 //void W25Q_test(void)
 //{
 //	uint8_t buf[W25Q_SECTOR_SIZE];
@@ -200,6 +463,10 @@ int8_t W25Q_init(void)
 	// Enable SD_SSP peripheral
 	SSP_Cmd(LPC_SSP1,ENABLE);
 	
+	// GPDMA for sector reads / page programs
+	CLKPWR_ConfigPPWR(CLKPWR_PCONP_PCGPDMA,ENABLE);
+	LPC_GPDMA->Config=GPDMA_DMACConfig_E;
+	
 	// reset the W25Q
 
 	reset();
@@ -13,10 +13,24 @@
 
 #define W25Q_SECTOR_COUNT 16384 // 64MB
 
+#define W25Q_PAGES_PER_SECTOR (W25Q_SECTOR_SIZE/W25Q_PAGE_SIZE)
+#define W25Q_ALL_PAGES ((1<<W25Q_PAGES_PER_SECTOR)-1)
+#define W25Q_ERASE 0x80000000 // pages mask flag, erase the sector before programming
+
 void W25Q_readSector(uint32_t index, uint8_t * buffer);
+void W25Q_readSectors(uint32_t index, uint32_t count, uint8_t * buffer); // one FAST_READ for consecutive sectors, also across calls
 void W25Q_writeSector(uint32_t index, const uint8_t * buffer);
 
+uint32_t W25Q_compareSector(uint32_t index, const uint8_t * buffer); // returns the pages mask needed to get buffer into the sector
+void W25Q_programSector(uint32_t index, const uint8_t * buffer, uint32_t pages);
+
+void W25Q_read(uint32_t address, uint8_t * buffer, uint32_t size);
+void W25Q_program(uint32_t address, const uint8_t * buffer, uint32_t size); // within one page, only clears bits
+void W25Q_eraseSector(uint32_t index);
+
 int8_t W25Q_init(void);
 
+void W25Q_benchmark(uint8_t * scratch); // DEBUG builds, prints read / program throughput, scratch: one sector
+
 #endif /* W25Q_H */
 
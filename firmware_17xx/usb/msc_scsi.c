@@ -98,6 +98,18 @@ static const U8 abSense[] = { 0x70, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x0A,
 //	Buffer for holding one block of disk data
 static U8 abBlockBuf[BLOCKSIZE];
 
+/*************************************************************************
+	SCSIGetBlockBuffer
+	==================
+		The block buffer is only used while in USB mass storage mode,
+		the rest of the time it can be borrowed as scratch memory.
+
+**************************************************************************/
+U8 * SCSIGetBlockBuffer(void)
+{
+	return abBlockBuf;
+}
+
 
 typedef struct {
 	U8		bOperationCode;
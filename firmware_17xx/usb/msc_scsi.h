@@ -30,3 +30,4 @@
 void	SCSIReset(void);
 U8 *	SCSIHandleCmd(U8 *pbCDB, U8 bCDBLen, int *piRspLen, BOOL *pfDevIn);
 U8 *	SCSIHandleData(U8 *pbCDB, U8 bCDBLen, U8 *pbData, U32 dwOffset);
+U8 *	SCSIGetBlockBuffer(void); // W25Q_SECTOR_SIZE bytes